@@ -0,0 +1,107 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "core/math.hpp"
+#include "core/collision.hpp"
+
+namespace {
+    struct Scenario {
+        const char *name;
+        size_t boxes;
+        size_t queries;
+    };
+
+    template<typename Fn>
+    double measureNanosPerQuery(const size_t queries, const int repeats, Fn &&fn) {
+        const auto start = std::chrono::steady_clock::now();
+        for (int r = 0; r < repeats; ++r) {
+            fn();
+        }
+        const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+        return elapsed.count() / static_cast<double>(queries * static_cast<size_t>(repeats));
+    }
+
+    const char *levelName(const core::SimdLevel level) {
+        switch (level) {
+            case core::SimdLevel::AVX2: return "avx2";
+            case core::SimdLevel::SSE2: return "sse2";
+            default: return "scalar";
+        }
+    }
+}
+
+int main() {
+    constexpr Scenario scenarios[] = {
+        {"space invaders (50 invaders, 8 bullets)", 50, 8},
+        {"large grid (5000 invaders, 64 bullets)", 5000, 64},
+        {"stress (100000 invaders, 16 bullets)", 100000, 16},
+    };
+
+    std::mt19937 gen{42};
+    std::uniform_real_distribution<float> coord{0.0f, 800.0f};
+
+    std::printf("detected SIMD level: %s\n\n", levelName(core::detectSimdLevel()));
+    uint64_t sink = 0;
+    bool mismatch = false;
+
+    for (const auto &[name, box_count, query_count]: scenarios) {
+        std::vector<core::Rectangle> rects;
+        core::AABBSoA soa;
+        soa.reserve(box_count);
+        for (size_t i = 0; i < box_count; ++i) {
+            const core::Rectangle rect{{coord(gen), coord(gen) * 0.75f}, {15.0f, 15.0f}};
+            rects.push_back(rect);
+            soa.push(rect.bounds());
+        }
+
+        std::vector<core::Rectangle> queries;
+        for (size_t i = 0; i < query_count; ++i) {
+            queries.push_back({{coord(gen), coord(gen) * 0.75f}, {2.0f, 5.0f}});
+        }
+
+        const int repeats = static_cast<int>(std::max<size_t>(1, 20'000'000 / (box_count * query_count)));
+        std::vector<uint64_t> mask(soa.maskWords());
+
+        std::printf("%s\n", name);
+
+        const double baseline = measureNanosPerQuery(query_count, repeats, [&] {
+            for (const auto &query: queries) {
+                for (size_t i = 0; i < rects.size(); ++i) {
+                    if (query.intersects(rects[i])) sink += i;
+                }
+            }
+        });
+        std::printf("  %-28s %10.1f ns/query\n", "Rectangle::intersects loop", baseline);
+
+        for (const auto level: {core::SimdLevel::Scalar, core::SimdLevel::SSE2, core::SimdLevel::AVX2}) {
+            if (level > core::detectSimdLevel()) continue;
+
+            for (const auto &query: queries) {
+                core::intersectBatch(query.bounds(), soa, mask, level);
+                for (size_t i = 0; i < rects.size(); ++i) {
+                    if (((mask[i / 64] >> (i % 64)) & 1) != static_cast<uint64_t>(query.intersects(rects[i]))) {
+                        mismatch = true;
+                    }
+                }
+            }
+
+            const double ns = measureNanosPerQuery(query_count, repeats, [&] {
+                for (const auto &query: queries) {
+                    if (core::intersectBatch(query.bounds(), soa, mask, level)) sink += mask[0];
+                }
+            });
+            std::printf("  %-28s %10.1f ns/query  (%.2fx)\n", levelName(level), ns, baseline / ns);
+        }
+        std::printf("\n");
+    }
+
+    if (mismatch) {
+        std::printf("kernel results differ from Rectangle::intersects\n");
+        return 1;
+    }
+    std::printf("checksum %llu\n", static_cast<unsigned long long>(sink));
+    return 0;
+}
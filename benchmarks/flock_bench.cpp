@@ -0,0 +1,64 @@
+#include <chrono>
+#include <cstdio>
+#include <cmath>
+#include <vector>
+
+#include "games/flappy_bird/population.hpp"
+
+namespace {
+    constexpr size_t BIRDS = 100'000;
+    constexpr float TICK = 1.0f / 120.0f;
+    constexpr int TICKS = 1200;
+
+    const char *levelName(const core::SimdLevel level) {
+        switch (level) {
+            case core::SimdLevel::AVX2: return "avx2";
+            case core::SimdLevel::SSE2: return "sse2";
+            default: return "scalar";
+        }
+    }
+}
+
+int main() {
+    using namespace games::flappy_bird;
+
+    std::printf("detected SIMD level: %s\n", levelName(core::detectSimdLevel()));
+    std::printf("%zu birds at %.0f Hz, step + compaction per tick, fill per frame\n\n", BIRDS, 1.0f / TICK);
+
+    std::vector<core::Quad> quads(BIRDS);
+    double checksum = 0.0;
+
+    for (const auto level: {core::SimdLevel::Scalar, core::SimdLevel::SSE2, core::SimdLevel::AVX2}) {
+        if (level > core::detectSimdLevel()) continue;
+
+        BirdFlock flock{BIRDS, level};
+        double step_ms = 0.0, fill_ms = 0.0, worst_ms = 0.0;
+        for (int tick = 0; tick < TICKS; ++tick) {
+            // Keep the flock full so every tick steps all of it; a gap drifting through
+            // the band makes some birds die and get compacted each tick.
+            while (flock.size() < flock.capacity()) {
+                flock.spawn(-60.0f + static_cast<float>(flock.size() % 100), static_cast<float>(flock.size() % 30) * 0.01f);
+            }
+            const float center = 300.0f + 120.0f * std::sin(static_cast<float>(tick) * 0.01f);
+            const detail::FlockStep step{TICK, center, center - 65.0f, center + 65.0f};
+
+            const auto start = std::chrono::steady_clock::now();
+            if (flock.step(step) > 0) flock.removeDead();
+            const auto stepped = std::chrono::steady_clock::now();
+            flock.fill(std::span{quads}.first(flock.size()), 96);
+            const auto filled = std::chrono::steady_clock::now();
+
+            const double stepping = std::chrono::duration<double, std::milli>(stepped - start).count();
+            step_ms += stepping;
+            fill_ms += std::chrono::duration<double, std::milli>(filled - stepped).count();
+            worst_ms = std::max(worst_ms, stepping);
+            checksum += quads[static_cast<size_t>(tick) % flock.size()].y;
+        }
+
+        std::printf("  %-8s step %6.3f ms  worst %6.3f ms  fill %6.3f ms\n",
+                    levelName(level), step_ms / TICKS, worst_ms, fill_ms / TICKS);
+    }
+
+    std::printf("\nchecksum %.1f\n", checksum);
+    return 0;
+}
@@ -0,0 +1,67 @@
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+#include "core/particles.hpp"
+
+namespace {
+    constexpr size_t PARTICLES = 100'000;
+    constexpr float TICK = 1.0f / 120.0f;
+    constexpr int FRAMES = 1200;
+
+    // Long-lived bursts so the pool stays full and every frame integrates all of it.
+    constexpr core::ParticlePreset STEADY{256, 40.0f, 160.0f, 0.0f, 6.2831853f, 5.0f, 10.0f, 4.0f, -120.0f, 255, 140, 40};
+
+    const char *levelName(const core::SimdLevel level) {
+        switch (level) {
+            case core::SimdLevel::AVX2: return "avx2";
+            case core::SimdLevel::SSE2: return "sse2";
+            default: return "scalar";
+        }
+    }
+}
+
+int main() {
+    std::printf("detected SIMD level: %s\n", levelName(core::detectSimdLevel()));
+    std::printf("%zu particles at %.0f Hz, update + fill per frame\n\n", PARTICLES, 1.0f / TICK);
+
+    std::vector<core::Quad> quads(PARTICLES);
+    double checksum = 0.0;
+
+    for (const auto level: {core::SimdLevel::Scalar, core::SimdLevel::SSE2, core::SimdLevel::AVX2}) {
+        if (level > core::detectSimdLevel()) continue;
+
+        core::ParticleSystem particles{PARTICLES, level};
+        while (particles.size() < particles.capacity()) {
+            particles.emit(STEADY, {400.0f, 300.0f});
+        }
+
+        double update_ms = 0.0, fill_ms = 0.0, worst_ms = 0.0;
+        for (int frame = 0; frame < FRAMES; ++frame) {
+            // Top up what expired so the pool stays at capacity.
+            while (particles.size() < particles.capacity()) {
+                particles.emit(STEADY, {400.0f, 300.0f});
+            }
+
+            const auto start = std::chrono::steady_clock::now();
+            particles.update(TICK);
+            const auto updated = std::chrono::steady_clock::now();
+            particles.fill(std::span{quads}.first(particles.size()));
+            const auto filled = std::chrono::steady_clock::now();
+
+            const double update = std::chrono::duration<double, std::milli>(updated - start).count();
+            const double fill = std::chrono::duration<double, std::milli>(filled - updated).count();
+            update_ms += update;
+            fill_ms += fill;
+            worst_ms = std::max(worst_ms, update + fill);
+            checksum += quads[frame % particles.size()].x;
+        }
+
+        std::printf("  %-8s update %6.3f ms  fill %6.3f ms  total %6.3f ms  worst %6.3f ms\n",
+                    levelName(level), update_ms / FRAMES, fill_ms / FRAMES,
+                    (update_ms + fill_ms) / FRAMES, worst_ms);
+    }
+
+    std::printf("\nchecksum %.1f\n", checksum);
+    return 0;
+}
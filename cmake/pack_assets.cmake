@@ -0,0 +1,75 @@
+# Packs assets into one indexed archive embedded as a C++ header.
+# Usage: cmake -DMANIFEST=<file> -DOUTPUT=<header> -P pack_assets.cmake
+#
+# Each manifest line is "<asset name>=<path>". The archive is a single 16-byte
+# aligned blob holding every file back to back, plus an entry table of
+# {name, offset, size}. core::assets builds its hashed lookup table from that
+# table at compile time.
+
+if(NOT MANIFEST OR NOT OUTPUT)
+    message(FATAL_ERROR "pack_assets.cmake needs -DMANIFEST=... and -DOUTPUT=...")
+endif()
+
+file(STRINGS "${MANIFEST}" lines)
+
+set(blob "")
+set(entries "")
+set(offset 0)
+set(count 0)
+
+foreach(line IN LISTS lines)
+    if(NOT line MATCHES "^([^=]+)=(.+)$")
+        continue()
+    endif()
+    set(name "${CMAKE_MATCH_1}")
+    set(path "${CMAKE_MATCH_2}")
+
+    if(NOT EXISTS "${path}")
+        message(WARNING "Asset ${name} not found at ${path}; skipping")
+        continue()
+    endif()
+
+    file(SIZE "${path}" size)
+    file(READ "${path}" hex HEX)
+    string(REGEX REPLACE "([0-9a-f][0-9a-f])" "0x\\1," bytes "${hex}")
+
+    string(APPEND blob "        // ${name}\n        ${bytes}\n")
+    string(APPEND entries "        Entry{\"${name}\", ${offset}, ${size}},\n")
+
+    math(EXPR offset "${offset} + ${size}")
+    math(EXPR padding "(16 - ${offset} % 16) % 16")
+    if(padding GREATER 0)
+        string(REPEAT "0x00," ${padding} pad)
+        string(APPEND blob "        ${pad}\n")
+        math(EXPR offset "${offset} + ${padding}")
+    endif()
+    math(EXPR count "${count} + 1")
+endforeach()
+
+if(offset EQUAL 0)
+    set(blob "        0x00,\n")
+endif()
+
+file(WRITE "${OUTPUT}.tmp" "// Generated by cmake/pack_assets.cmake. Do not edit.
+#pragma once
+#include <array>
+#include <cstddef>
+
+namespace core::assets::generated {
+    struct Entry {
+        const char *name;
+        std::size_t offset;
+        std::size_t size;
+    };
+
+    alignas(16) inline constexpr unsigned char BLOB[] = {
+${blob}    };
+
+    inline constexpr std::array<Entry, ${count}> ENTRIES{
+${entries}    };
+}
+")
+
+# Only touch the header when the archive changed so dependents do not rebuild needlessly.
+execute_process(COMMAND "${CMAKE_COMMAND}" -E copy_if_different "${OUTPUT}.tmp" "${OUTPUT}")
+file(REMOVE "${OUTPUT}.tmp")
@@ -0,0 +1,59 @@
+#pragma once
+// Counting replacements for the global allocation functions. They are definitions, so
+// include this from exactly one translation unit, and only in TRACK_ALLOCATIONS builds.
+// The array and nothrow forms forward to these in the standard library.
+#include <new>
+#include <cstdlib>
+#include "alloc_tracker.hpp"
+
+namespace core::alloc::detail {
+    inline void *allocateAligned(const std::size_t size, const std::align_val_t alignment) noexcept {
+        const auto align = static_cast<std::size_t>(alignment);
+#ifdef _WIN32
+        return _aligned_malloc(size ? size : 1, align);
+#else
+        // aligned_alloc wants a size that is a multiple of the alignment.
+        return std::aligned_alloc(align, ((size ? size : 1) + align - 1) & ~(align - 1));
+#endif
+    }
+
+    inline void freeAligned(void *memory) noexcept {
+#ifdef _WIN32
+        _aligned_free(memory);
+#else
+        std::free(memory);
+#endif
+    }
+}
+
+void *operator new(const std::size_t size) {
+    core::alloc::recordAllocation(size);
+    if (void *memory = std::malloc(size ? size : 1)) return memory;
+    throw std::bad_alloc();
+}
+
+void *operator new(const std::size_t size, const std::align_val_t alignment) {
+    core::alloc::recordAllocation(size);
+    if (void *memory = core::alloc::detail::allocateAligned(size, alignment)) return memory;
+    throw std::bad_alloc();
+}
+
+void operator delete(void *memory) noexcept {
+    if (!memory) return;
+    core::alloc::recordFree();
+    std::free(memory);
+}
+
+void operator delete(void *memory, std::size_t) noexcept {
+    operator delete(memory);
+}
+
+void operator delete(void *memory, std::align_val_t) noexcept {
+    if (!memory) return;
+    core::alloc::recordFree();
+    core::alloc::detail::freeAligned(memory);
+}
+
+void operator delete(void *memory, std::size_t, const std::align_val_t alignment) noexcept {
+    operator delete(memory, alignment);
+}
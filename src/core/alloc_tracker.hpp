@@ -0,0 +1,187 @@
+#pragma once
+#include <SDL2/SDL.h>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <ostream>
+#include <iomanip>
+#include <algorithm>
+
+namespace core::alloc {
+#ifdef TRACK_ALLOCATIONS
+    inline constexpr bool TRACKING = true;
+#else
+    inline constexpr bool TRACKING = false;
+#endif
+
+    // Subsystem an allocation is charged to: whichever tag the allocating thread has open.
+    enum class Tag : uint8_t {
+        Other,
+        Input,
+        Update,
+        Collision,
+        Text,
+        Render,
+        Audio,
+        Count
+    };
+
+    inline constexpr size_t TAG_COUNT = static_cast<size_t>(Tag::Count);
+
+    [[nodiscard]] constexpr const char *toString(const Tag tag) noexcept {
+        switch (tag) {
+            case Tag::Input: return "input";
+            case Tag::Update: return "update";
+            case Tag::Collision: return "collision";
+            case Tag::Text: return "text";
+            case Tag::Render: return "render";
+            case Tag::Audio: return "audio";
+            case Tag::Other:
+            default: return "other";
+        }
+    }
+
+    struct Counts {
+        uint64_t allocations{0};
+        uint64_t bytes{0};
+        uint64_t frees{0};
+    };
+
+    using FrameCounts = std::array<Counts, TAG_COUNT>;
+
+    namespace detail {
+        struct LiveCounts {
+            std::atomic<uint64_t> allocations{0};
+            std::atomic<uint64_t> bytes{0};
+            std::atomic<uint64_t> frees{0};
+        };
+
+        inline std::array<LiveCounts, TAG_COUNT> live{};
+        inline thread_local Tag current_tag = Tag::Other;
+
+        inline SDL_malloc_func sdl_malloc = nullptr;
+        inline SDL_calloc_func sdl_calloc = nullptr;
+        inline SDL_realloc_func sdl_realloc = nullptr;
+        inline SDL_free_func sdl_free = nullptr;
+    }
+
+    [[nodiscard]] inline Tag currentTag() noexcept { return detail::current_tag; }
+
+    // Called from the allocation hooks; must not allocate.
+    inline void recordAllocation(const size_t bytes) noexcept {
+        detail::LiveCounts &counts = detail::live[static_cast<size_t>(detail::current_tag)];
+        counts.allocations.fetch_add(1, std::memory_order_relaxed);
+        counts.bytes.fetch_add(bytes, std::memory_order_relaxed);
+    }
+
+    inline void recordFree() noexcept {
+        detail::live[static_cast<size_t>(detail::current_tag)].frees.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Charges allocations made on this thread to tag until the scope closes. Compiles to
+    // nothing unless allocation tracking is built in.
+    class Scope {
+        Tag previous_;
+
+    public:
+        explicit Scope(const Tag tag) noexcept : previous_(detail::current_tag) {
+            if constexpr (TRACKING) detail::current_tag = tag;
+        }
+
+        ~Scope() {
+            if constexpr (TRACKING) detail::current_tag = previous_;
+        }
+
+        Scope(const Scope &) = delete;
+
+        Scope &operator=(const Scope &) = delete;
+    };
+
+    // Routes SDL's own heap use (surfaces, SDL_ttf caches, event queues) through the
+    // counters. Must run before SDL allocates anything, i.e. before SDL_Init.
+    inline void hookSDL() {
+        if constexpr (!TRACKING) return;
+
+        SDL_GetMemoryFunctions(&detail::sdl_malloc, &detail::sdl_calloc, &detail::sdl_realloc, &detail::sdl_free);
+        SDL_SetMemoryFunctions(
+            [](const size_t size) -> void * {
+                recordAllocation(size);
+                return detail::sdl_malloc(size);
+            },
+            [](const size_t count, const size_t size) -> void * {
+                recordAllocation(count * size);
+                return detail::sdl_calloc(count, size);
+            },
+            [](void *memory, const size_t size) -> void * {
+                if (memory) recordFree();
+                if (size > 0) recordAllocation(size);
+                return detail::sdl_realloc(memory, size);
+            },
+            [](void *memory) {
+                if (memory) recordFree();
+                detail::sdl_free(memory);
+            });
+    }
+
+    // Collects the live counters once per frame and keeps totals for the exit report.
+    class Tracker {
+        FrameCounts last_{};
+        FrameCounts total_{};
+        std::array<uint64_t, TAG_COUNT> peak_allocations_{};
+        std::array<uint64_t, TAG_COUNT> frames_allocating_{};
+        uint64_t frames_{0};
+
+    public:
+        // Drops what was counted so far, e.g. startup, without recording it as a frame.
+        void discard() noexcept {
+            for (detail::LiveCounts &live: detail::live) {
+                live.allocations.store(0, std::memory_order_relaxed);
+                live.bytes.store(0, std::memory_order_relaxed);
+                live.frees.store(0, std::memory_order_relaxed);
+            }
+        }
+
+        void endFrame() noexcept {
+            for (size_t tag = 0; tag < TAG_COUNT; ++tag) {
+                detail::LiveCounts &live = detail::live[tag];
+                Counts &frame = last_[tag];
+                frame.allocations = live.allocations.exchange(0, std::memory_order_relaxed);
+                frame.bytes = live.bytes.exchange(0, std::memory_order_relaxed);
+                frame.frees = live.frees.exchange(0, std::memory_order_relaxed);
+
+                total_[tag].allocations += frame.allocations;
+                total_[tag].bytes += frame.bytes;
+                total_[tag].frees += frame.frees;
+                peak_allocations_[tag] = std::max(peak_allocations_[tag], frame.allocations);
+                if (frame.allocations > 0) ++frames_allocating_[tag];
+            }
+            ++frames_;
+        }
+
+        [[nodiscard]] const FrameCounts &lastFrame() const noexcept { return last_; }
+
+        void print(std::ostream &out) const {
+            if (frames_ == 0) return;
+
+            const std::ios_base::fmtflags flags = out.flags();
+            const std::streamsize precision = out.precision();
+            const auto frames = static_cast<double>(frames_);
+
+            out << "Heap allocations over " << frames_ << " frames:\n"
+                    << "  " << std::left << std::setw(10) << "tag" << std::right
+                    << std::setw(14) << "allocs/frame" << std::setw(14) << "bytes/frame"
+                    << std::setw(12) << "peak/frame" << std::setw(19) << "frames allocating" << "\n"
+                    << std::fixed << std::setprecision(2);
+            for (size_t tag = 0; tag < TAG_COUNT; ++tag) {
+                out << "  " << std::left << std::setw(10) << toString(static_cast<Tag>(tag)) << std::right
+                        << std::setw(14) << static_cast<double>(total_[tag].allocations) / frames
+                        << std::setw(14) << static_cast<double>(total_[tag].bytes) / frames
+                        << std::setw(12) << peak_allocations_[tag]
+                        << std::setw(19) << frames_allocating_[tag] << "\n";
+            }
+            out.flags(flags);
+            out.precision(precision);
+        }
+    };
+}
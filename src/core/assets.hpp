@@ -0,0 +1,77 @@
+#pragma once
+#include <SDL2/SDL.h>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <cstddef>
+#include <string_view>
+#include <asset_archive_data.hpp>
+
+namespace core::assets {
+    using AssetId = uint64_t;
+
+    // FNV-1a; evaluated at compile time for the literal names used in lookups.
+    [[nodiscard]] consteval AssetId id(const std::string_view name) {
+        AssetId hash = 0xcbf29ce484222325ull;
+        for (const char c: name) {
+            hash ^= static_cast<unsigned char>(c);
+            hash *= 0x100000001b3ull;
+        }
+        return hash;
+    }
+
+    // Read-only view of a packed asset; the bytes live in the binary for the whole run.
+    struct Asset {
+        const unsigned char *data{};
+        size_t size{};
+
+        [[nodiscard]] constexpr explicit operator bool() const noexcept { return data != nullptr; }
+
+        // Zero-copy stream over the asset; the caller owns (and may hand off) the RWops.
+        [[nodiscard]] SDL_RWops *open() const noexcept {
+            return data ? SDL_RWFromConstMem(data, static_cast<int>(size)) : nullptr;
+        }
+    };
+
+    namespace detail {
+        struct Slot {
+            AssetId id{};
+            uint32_t entry{UINT32_MAX};
+        };
+
+        inline constexpr size_t TABLE_SIZE = std::bit_ceil(generated::ENTRIES.size() * 2 + 1);
+
+        [[nodiscard]] consteval AssetId hashName(const char *name) {
+            return id(std::string_view{name});
+        }
+
+        // Open addressing with linear probing, built once by the compiler from the
+        // archive's entry table.
+        [[nodiscard]] consteval std::array<Slot, TABLE_SIZE> buildTable() {
+            std::array<Slot, TABLE_SIZE> table{};
+            for (uint32_t entry = 0; entry < generated::ENTRIES.size(); ++entry) {
+                const AssetId hash = hashName(generated::ENTRIES[entry].name);
+                size_t slot = hash & (TABLE_SIZE - 1);
+                while (table[slot].entry != UINT32_MAX) {
+                    if (table[slot].id == hash) throw "duplicate asset id";
+                    slot = (slot + 1) & (TABLE_SIZE - 1);
+                }
+                table[slot] = {hash, entry};
+            }
+            return table;
+        }
+
+        inline constexpr std::array<Slot, TABLE_SIZE> TABLE = buildTable();
+    }
+
+    [[nodiscard]] constexpr Asset find(const AssetId asset) noexcept {
+        for (size_t slot = asset & (detail::TABLE_SIZE - 1);; slot = (slot + 1) & (detail::TABLE_SIZE - 1)) {
+            const detail::Slot &candidate = detail::TABLE[slot];
+            if (candidate.entry == UINT32_MAX) return {};
+            if (candidate.id == asset) {
+                const generated::Entry &entry = generated::ENTRIES[candidate.entry];
+                return {generated::BLOB + entry.offset, entry.size};
+            }
+        }
+    }
+}
@@ -0,0 +1,435 @@
+#pragma once
+#include <SDL2/SDL.h>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <span>
+#include <string>
+#include <vector>
+#include "assets.hpp"
+#include "alloc_tracker.hpp"
+#include "spsc_queue.hpp"
+#include "music.hpp"
+
+namespace core::audio {
+    enum class Sound : uint8_t {
+        Shot,
+        Hit,
+        Flap,
+        Score,
+        Count
+    };
+
+    inline constexpr size_t SOUND_COUNT = static_cast<size_t>(Sound::Count);
+
+    // A WAV packed under these names replaces the built-in synthesized effect.
+    inline constexpr std::array<assets::AssetId, SOUND_COUNT> SOUND_ASSETS{
+        assets::id("sounds/shot.wav"),
+        assets::id("sounds/hit.wav"),
+        assets::id("sounds/flap.wav"),
+        assets::id("sounds/score.wav"),
+    };
+
+    // Counters since the device opened. Latency is from play() to the callback that
+    // starts the sound; the device buffer adds buffer_latency_us on top.
+    struct Stats {
+        uint64_t callbacks{0};
+        uint64_t underruns{0};
+        uint64_t dropped_commands{0};
+        uint64_t stolen_voices{0};
+        uint64_t music_underrun_frames{0};
+        uint32_t last_latency_us{0};
+        uint32_t max_latency_us{0};
+        uint32_t buffer_latency_us{0};
+    };
+
+    namespace detail {
+        // Mono float at the device rate, converted from whatever the WAV holds.
+        [[nodiscard]] inline bool decodeWav(const assets::Asset asset, const int freq, std::vector<float> &out) {
+            SDL_AudioSpec spec{};
+            Uint8 *buffer = nullptr;
+            Uint32 length = 0;
+            if (!asset || !SDL_LoadWAV_RW(asset.open(), 1, &spec, &buffer, &length)) return false;
+
+            SDL_AudioCVT cvt{};
+            if (SDL_BuildAudioCVT(&cvt, spec.format, spec.channels, spec.freq, AUDIO_F32SYS, 1, freq) < 0) {
+                SDL_FreeWAV(buffer);
+                return false;
+            }
+
+            std::vector<Uint8> work(static_cast<size_t>(length) * static_cast<size_t>(std::max(cvt.len_mult, 1)));
+            std::memcpy(work.data(), buffer, length);
+            SDL_FreeWAV(buffer);
+            cvt.buf = work.data();
+            cvt.len = static_cast<int>(length);
+            if (cvt.needed && SDL_ConvertAudio(&cvt) < 0) return false;
+
+            const size_t bytes = cvt.needed ? static_cast<size_t>(cvt.len_cvt) : length;
+            out.resize(bytes / sizeof(float));
+            std::memcpy(out.data(), work.data(), out.size() * sizeof(float));
+            return true;
+        }
+
+        // Square-wave and noise blips in the spirit of the games, so there is sound
+        // without shipping any audio files.
+        [[nodiscard]] inline std::vector<float> synthesize(const Sound sound, const int freq) {
+            const auto rate = static_cast<float>(freq);
+            const auto square = [](const float phase) { return phase - std::floor(phase) < 0.5f ? 1.0f : -1.0f; };
+
+            std::vector<float> samples;
+            const auto generate = [&](const float seconds, auto &&sample) {
+                const auto count = static_cast<size_t>(seconds * rate);
+                samples.reserve(samples.size() + count);
+                for (size_t i = 0; i < count; ++i) {
+                    const float t = static_cast<float>(i) / rate;
+                    samples.push_back(sample(t, t / seconds));
+                }
+            };
+
+            switch (sound) {
+                case Sound::Shot: {
+                    // Falling sweep, 1200 Hz down to 300 Hz.
+                    float phase = 0.0f;
+                    generate(0.12f, [&](float, const float progress) {
+                        phase += (1200.0f - 900.0f * progress) / rate;
+                        return 0.25f * square(phase) * (1.0f - progress);
+                    });
+                    break;
+                }
+                case Sound::Hit: {
+                    std::minstd_rand noise{0x41};
+                    std::uniform_real_distribution<float> white{-1.0f, 1.0f};
+                    float low = 0.0f;
+                    generate(0.25f, [&](float, const float progress) {
+                        low += 0.35f * (white(noise) - low);
+                        const float envelope = (1.0f - progress) * (1.0f - progress);
+                        return 0.6f * low * envelope;
+                    });
+                    break;
+                }
+                case Sound::Flap: {
+                    float phase = 0.0f;
+                    generate(0.08f, [&](float, const float progress) {
+                        phase += (300.0f + 400.0f * progress) / rate;
+                        return 0.3f * std::sin(6.2831853f * phase) * (1.0f - progress);
+                    });
+                    break;
+                }
+                case Sound::Score:
+                    // Two rising notes.
+                    for (const float pitch: {660.0f, 990.0f}) {
+                        generate(0.07f, [&](const float t, const float progress) {
+                            return 0.2f * square(pitch * t) * (1.0f - 0.5f * progress);
+                        });
+                    }
+                    break;
+                case Sound::Count:
+                    break;
+            }
+            return samples;
+        }
+    }
+
+    // Decoded effects, filled once before the device starts and only read afterwards.
+    class SampleCache {
+        std::array<std::vector<float>, SOUND_COUNT> samples_;
+
+    public:
+        void load(const int freq) {
+            for (size_t i = 0; i < SOUND_COUNT; ++i) {
+                if (!detail::decodeWav(assets::find(SOUND_ASSETS[i]), freq, samples_[i])) {
+                    samples_[i] = detail::synthesize(static_cast<Sound>(i), freq);
+                }
+            }
+        }
+
+        [[nodiscard]] std::span<const float> get(const Sound sound) const noexcept {
+            return samples_[static_cast<size_t>(sound)];
+        }
+    };
+
+    // Plays cached effects and streamed music through one SDL audio device. Game code
+    // posts commands to a lock-free queue; the audio callback drains it and mixes into a
+    // fixed voice table, so the callback never locks, allocates or waits on the game.
+    // Until open() succeeds, and when it fails, every call is a no-op and the games run
+    // silent.
+    class AudioSystem {
+        enum class CommandType : uint8_t {
+            Play,
+            Stop,
+            StopAll
+        };
+
+        struct Command {
+            CommandType type;
+            Sound sound;
+            float gain;
+            float pan;
+            Uint64 issued;
+        };
+
+        struct Voice {
+            const float *samples{nullptr};
+            uint32_t length{0};
+            uint32_t position{0};
+            float left{0.0f}, right{0.0f};
+            Sound sound{Sound::Count};
+        };
+
+        static constexpr size_t MAX_VOICES = 32;
+        static constexpr size_t COMMAND_CAPACITY = 256;
+        static constexpr int FREQUENCY = 48000;
+        static constexpr Uint16 BUFFER_FRAMES = 512;
+
+        SDL_AudioDeviceID device_{0};
+        SDL_AudioSpec spec_{};
+        SampleCache cache_;
+        SpscQueue<Command, COMMAND_CAPACITY> commands_;
+        MusicPlayer music_;
+        // Game thread only.
+        bool muted_{false};
+
+        // Callback thread only.
+        std::array<Voice, MAX_VOICES> voices_{};
+        Uint64 last_callback_{0};
+        Uint64 late_ticks_{0};
+        Uint64 counter_frequency_{1};
+
+        // Each counter has a single writer, so it advances with a plain load and store.
+        std::atomic<uint64_t> callbacks_{0};
+        std::atomic<uint64_t> underruns_{0};
+        std::atomic<uint64_t> stolen_voices_{0};
+        std::atomic<uint32_t> last_latency_us_{0};
+        std::atomic<uint32_t> max_latency_us_{0};
+        std::atomic<uint64_t> dropped_commands_{0};
+
+        static void bump(std::atomic<uint64_t> &counter) noexcept {
+            counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        }
+
+        void post(const Command &command) noexcept {
+            if (!device_) return;
+            if (!commands_.push(command)) bump(dropped_commands_);
+        }
+
+        void start(const Command &command) noexcept {
+            const std::span<const float> samples = cache_.get(command.sound);
+            if (samples.empty()) return;
+
+            // A free voice if there is one, otherwise the one closest to finishing.
+            Voice *voice = &voices_[0];
+            for (Voice &candidate: voices_) {
+                if (!candidate.samples) {
+                    voice = &candidate;
+                    break;
+                }
+                if (candidate.length - candidate.position < voice->length - voice->position) voice = &candidate;
+            }
+            if (voice->samples) bump(stolen_voices_);
+
+            const float pan = std::clamp(command.pan, -1.0f, 1.0f);
+            voice->samples = samples.data();
+            voice->length = static_cast<uint32_t>(samples.size());
+            voice->position = 0;
+            voice->left = command.gain * std::min(1.0f, 1.0f - pan);
+            voice->right = command.gain * std::min(1.0f, 1.0f + pan);
+            voice->sound = command.sound;
+        }
+
+        void apply(const Command &command, const Uint64 now) noexcept {
+            const auto latency = static_cast<uint32_t>((now - command.issued) * 1'000'000 / counter_frequency_);
+            last_latency_us_.store(latency, std::memory_order_relaxed);
+            if (latency > max_latency_us_.load(std::memory_order_relaxed)) {
+                max_latency_us_.store(latency, std::memory_order_relaxed);
+            }
+
+            switch (command.type) {
+                case CommandType::Play:
+                    start(command);
+                    break;
+                case CommandType::Stop:
+                    for (Voice &voice: voices_) {
+                        if (voice.sound == command.sound) voice.samples = nullptr;
+                    }
+                    break;
+                case CommandType::StopAll:
+                    for (Voice &voice: voices_) voice.samples = nullptr;
+                    break;
+            }
+        }
+
+        void mix(float *out, const size_t frames) noexcept {
+            const size_t channels = spec_.channels;
+            std::fill_n(out, frames * channels, 0.0f);
+
+            for (Voice &voice: voices_) {
+                if (!voice.samples) continue;
+
+                const size_t count = std::min<size_t>(frames, voice.length - voice.position);
+                const float *source = voice.samples + voice.position;
+                if (channels == 1) {
+                    for (size_t i = 0; i < count; ++i) out[i] += source[i] * voice.left;
+                } else {
+                    // Anything past stereo is left silent.
+                    for (size_t i = 0; i < count; ++i) {
+                        out[i * channels] += source[i] * voice.left;
+                        out[i * channels + 1] += source[i] * voice.right;
+                    }
+                }
+
+                voice.position += static_cast<uint32_t>(count);
+                if (voice.position >= voice.length) voice.samples = nullptr;
+            }
+
+            music_.mix(out, frames, channels);
+
+            for (size_t i = 0; i < frames * channels; ++i) {
+                out[i] = std::clamp(out[i], -1.0f, 1.0f);
+            }
+        }
+
+        void render(Uint8 *stream, const int bytes) noexcept {
+            const alloc::Scope alloc_scope{alloc::Tag::Audio};
+            const Uint64 now = SDL_GetPerformanceCounter();
+
+            // A callback this late means the device most likely played out its buffer.
+            if (last_callback_ != 0 && now - last_callback_ > late_ticks_) bump(underruns_);
+            last_callback_ = now;
+            bump(callbacks_);
+
+            Command command{};
+            while (commands_.pop(command)) {
+                apply(command, now);
+            }
+
+            mix(reinterpret_cast<float *>(stream),
+                static_cast<size_t>(bytes) / (sizeof(float) * spec_.channels));
+        }
+
+        static void callback(void *self, Uint8 *stream, const int bytes) {
+            static_cast<AudioSystem *>(self)->render(stream, bytes);
+        }
+
+    public:
+        AudioSystem() = default;
+
+        ~AudioSystem() {
+            close();
+        }
+
+        AudioSystem(const AudioSystem &) = delete;
+
+        AudioSystem &operator=(const AudioSystem &) = delete;
+
+        // Process-wide mixer that games post to; GameManager opens and closes it.
+        static AudioSystem &shared() {
+            static AudioSystem audio;
+            return audio;
+        }
+
+        // Returns false, after saying why, when there is no usable device.
+        bool open() {
+            if (device_) return true;
+
+            if (SDL_InitSubSystem(SDL_INIT_AUDIO) < 0) {
+                std::cerr << "Audio disabled: " << SDL_GetError() << "\n";
+                return false;
+            }
+
+            SDL_AudioSpec want{};
+            want.freq = FREQUENCY;
+            want.format = AUDIO_F32SYS;
+            want.channels = 2;
+            want.samples = BUFFER_FRAMES;
+            want.callback = callback;
+            want.userdata = this;
+
+            // Format and channel count stay as asked; the mixer only handles float.
+            const SDL_AudioDeviceID device = SDL_OpenAudioDevice(nullptr, 0, &want, &spec_,
+                                                                 SDL_AUDIO_ALLOW_FREQUENCY_CHANGE |
+                                                                 SDL_AUDIO_ALLOW_SAMPLES_CHANGE);
+            if (device == 0) {
+                std::cerr << "Audio disabled: " << SDL_GetError() << "\n";
+                SDL_QuitSubSystem(SDL_INIT_AUDIO);
+                return false;
+            }
+
+            cache_.load(spec_.freq);
+            music_.open(spec_.freq);
+
+            counter_frequency_ = SDL_GetPerformanceFrequency();
+            late_ticks_ = counter_frequency_ * spec_.samples * 3 / (2 * static_cast<Uint64>(spec_.freq));
+            last_callback_ = 0;
+
+            device_ = device;
+            SDL_PauseAudioDevice(device_, 0);
+            return true;
+        }
+
+        void close() {
+            if (!device_) return;
+            SDL_CloseAudioDevice(device_);
+            music_.close();
+            SDL_QuitSubSystem(SDL_INIT_AUDIO);
+            device_ = 0;
+            voices_ = {};
+        }
+
+        // These post to the mixer and must all be called from the same thread, the one
+        // running the games.
+        void play(const Sound sound, const float gain = 1.0f, const float pan = 0.0f) noexcept {
+            if (muted_) return;
+            post({CommandType::Play, sound, gain, pan, SDL_GetPerformanceCounter()});
+        }
+
+        void stop(const Sound sound) noexcept {
+            post({CommandType::Stop, sound, 0.0f, 0.0f, SDL_GetPerformanceCounter()});
+        }
+
+        void stopAll() noexcept {
+            post({CommandType::StopAll, Sound::Count, 0.0f, 0.0f, SDL_GetPerformanceCounter()});
+        }
+
+        // Drops sound effects while set, so fast-forwarding through ticks stays quiet.
+        void setMuted(const bool muted) noexcept { muted_ = muted; }
+
+        // Crossfades to a local WAV or raw PCM file, looping it; an empty path fades the
+        // music out.
+        void playMusic(std::string path) {
+            if (device_) music_.play(std::move(path));
+        }
+
+        [[nodiscard]] bool isOpen() const noexcept { return device_ != 0; }
+
+        [[nodiscard]] Stats stats() const noexcept {
+            Stats stats;
+            stats.callbacks = callbacks_.load(std::memory_order_relaxed);
+            stats.underruns = underruns_.load(std::memory_order_relaxed);
+            stats.dropped_commands = dropped_commands_.load(std::memory_order_relaxed);
+            stats.stolen_voices = stolen_voices_.load(std::memory_order_relaxed);
+            stats.music_underrun_frames = music_.underrunFrames();
+            stats.last_latency_us = last_latency_us_.load(std::memory_order_relaxed);
+            stats.max_latency_us = max_latency_us_.load(std::memory_order_relaxed);
+            if (device_) {
+                stats.buffer_latency_us = static_cast<uint32_t>(
+                    static_cast<uint64_t>(spec_.samples) * 1'000'000 / static_cast<uint64_t>(spec_.freq));
+            }
+            return stats;
+        }
+
+        void printStats(std::ostream &out) const {
+            const Stats s = stats();
+            out << "Audio: " << s.callbacks << " callbacks, " << s.underruns << " underruns, "
+                    << s.dropped_commands << " dropped commands, " << s.stolen_voices << " stolen voices, "
+                    << s.music_underrun_frames << " music frames missed; "
+                    << "command latency " << s.last_latency_us << " us last, " << s.max_latency_us
+                    << " us max, plus " << s.buffer_latency_us << " us of device buffer\n";
+        }
+    };
+}
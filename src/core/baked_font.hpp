@@ -0,0 +1,93 @@
+#pragma once
+#include <SDL2/SDL.h>
+#include <string_view>
+#include <cmath>
+#include <cstdlib>
+#include <algorithm>
+#include <span>
+#include "render_commands.hpp"
+#ifdef HAS_BAKED_FONT
+#include <baked_font_data.hpp>
+#endif
+
+namespace core {
+#ifdef HAS_BAKED_FONT
+    inline constexpr bool BAKED_FONT_AVAILABLE = true;
+
+    // UI text drawn from the coverage atlas tools/font_baker.cpp rasterizes at build
+    // time. The backend holds the atlas as a texture from startup, and each string is
+    // recorded as one quad per glyph into it, with no FreeType or font loading at runtime.
+    class BakedFont {
+        [[nodiscard]] static const baked_font::Face &faceFor(const float scale) noexcept {
+            const int target = std::clamp(static_cast<int>(24 * scale), 8, 128);
+            return *std::ranges::min_element(baked_font::FACES, {}, [target](const baked_font::Face &face) {
+                return std::abs(face.size - target);
+            });
+        }
+
+        [[nodiscard]] static const baked_font::Glyph &glyphFor(const baked_font::Face &face, const char c) noexcept {
+            const int index = static_cast<unsigned char>(c) - baked_font::FIRST_GLYPH;
+            return face.glyphs[index >= 0 && index < baked_font::GLYPH_COUNT ? index : '?' - baked_font::FIRST_GLYPH];
+        }
+
+    public:
+        [[nodiscard]] static GlyphAtlas atlas() noexcept {
+            return {baked_font::ATLAS, baked_font::ATLAS_WIDTH, baked_font::ATLAS_HEIGHT};
+        }
+
+        [[nodiscard]] static float textWidth(const std::string_view text, const float scale) noexcept {
+            const baked_font::Face &face = faceFor(scale);
+            int width = 0;
+            for (const char c: text) {
+                width += glyphFor(face, c).advance;
+            }
+            return static_cast<float>(width);
+        }
+
+        [[nodiscard]] static float textHeight(const float scale) noexcept {
+            return static_cast<float>(faceFor(scale).height);
+        }
+
+        // Positions text exactly as FontManager::renderText does.
+        static void render(RenderCommandList &commands, const std::string_view text, const float x, const float y,
+                           const float scale, const float r, const float g, const float b, const float a) {
+            const baked_font::Face &face = faceFor(scale);
+            size_t visible = 0;
+            for (const char c: text) {
+                const baked_font::Glyph &glyph = glyphFor(face, c);
+                if (glyph.width > 0 && glyph.height > 0) ++visible;
+            }
+            if (visible == 0) return;
+
+            const auto channel = [](const float value) {
+                return static_cast<Uint8>(std::clamp(value, 0.0f, 1.0f) * 255.0f);
+            };
+            // Alpha applies twice, as on the SDL_ttf path, which renders the string with it
+            // and then draws the image with it again.
+            const Uint8 red = channel(r), green = channel(g), blue = channel(b), alpha = channel(a * a);
+
+            // Glyph offsets are measured down from the top of the line box.
+            const float left = std::round(x);
+            const float top = std::round(y) - static_cast<float>(face.ascent) + static_cast<float>(face.height);
+
+            const std::span<GlyphQuad> quads = commands.drawGlyphs(visible);
+            size_t next = 0;
+            int pen = 0;
+            for (const char c: text) {
+                const baked_font::Glyph &glyph = glyphFor(face, c);
+                if (glyph.width > 0 && glyph.height > 0) {
+                    quads[next++] = {
+                        left + static_cast<float>(pen + glyph.offset_x),
+                        top - static_cast<float>(glyph.offset_y + glyph.height),
+                        glyph.x, glyph.y, glyph.width, glyph.height,
+                        red, green, blue, alpha
+                    };
+                }
+                pen += glyph.advance;
+            }
+        }
+    };
+#else
+    inline constexpr bool BAKED_FONT_AVAILABLE = false;
+#endif
+}
@@ -0,0 +1,304 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <span>
+#include <vector>
+#include <limits>
+#include <bit>
+#include <algorithm>
+#include <optional>
+#include "math.hpp"
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#include <immintrin.h>
+#define CORE_COLLISION_X86 1
+#endif
+
+namespace core {
+    enum class SimdLevel {
+        Scalar,
+        SSE2,
+        AVX2
+    };
+
+    // Boxes stored as separate min/max lanes. The lane count is padded to a multiple of
+    // LANE_BLOCK with empty boxes (min = +inf, max = -inf) that never intersect, so the
+    // kernels run without tails and removing a box is a single store.
+    class AABBSoA {
+        std::vector<float> min_x_, min_y_, max_x_, max_y_;
+        size_t size_{0};
+
+        static constexpr float EMPTY_MIN = std::numeric_limits<float>::infinity();
+        static constexpr float EMPTY_MAX = -std::numeric_limits<float>::infinity();
+
+    public:
+        static constexpr size_t LANE_BLOCK = 8;
+
+        void clear() noexcept {
+            size_ = 0;
+            min_x_.clear();
+            min_y_.clear();
+            max_x_.clear();
+            max_y_.clear();
+        }
+
+        void reserve(const size_t count) {
+            const size_t padded = (count + LANE_BLOCK - 1) / LANE_BLOCK * LANE_BLOCK;
+            min_x_.reserve(padded);
+            min_y_.reserve(padded);
+            max_x_.reserve(padded);
+            max_y_.reserve(padded);
+        }
+
+        size_t push(const AABB &box) {
+            if (size_ == min_x_.size()) {
+                min_x_.resize(size_ + LANE_BLOCK, EMPTY_MIN);
+                min_y_.resize(size_ + LANE_BLOCK, EMPTY_MIN);
+                max_x_.resize(size_ + LANE_BLOCK, EMPTY_MAX);
+                max_y_.resize(size_ + LANE_BLOCK, EMPTY_MAX);
+            }
+            set(size_, box);
+            return size_++;
+        }
+
+        void set(const size_t index, const AABB &box) noexcept {
+            min_x_[index] = box.min.x;
+            min_y_[index] = box.min.y;
+            max_x_[index] = box.max.x;
+            max_y_[index] = box.max.y;
+        }
+
+        void disable(const size_t index) noexcept {
+            min_x_[index] = EMPTY_MIN;
+            min_y_[index] = EMPTY_MIN;
+            max_x_[index] = EMPTY_MAX;
+            max_y_[index] = EMPTY_MAX;
+        }
+
+        [[nodiscard]] AABB get(const size_t index) const noexcept {
+            return {{min_x_[index], min_y_[index]}, {max_x_[index], max_y_[index]}};
+        }
+
+        [[nodiscard]] size_t size() const noexcept { return size_; }
+        [[nodiscard]] bool empty() const noexcept { return size_ == 0; }
+        [[nodiscard]] size_t paddedSize() const noexcept { return min_x_.size(); }
+
+        // Number of 64-bit words a hit mask over this array needs.
+        [[nodiscard]] size_t maskWords() const noexcept { return (paddedSize() + 63) / 64; }
+
+        [[nodiscard]] const float *minX() const noexcept { return min_x_.data(); }
+        [[nodiscard]] const float *minY() const noexcept { return min_y_.data(); }
+        [[nodiscard]] const float *maxX() const noexcept { return max_x_.data(); }
+        [[nodiscard]] const float *maxY() const noexcept { return max_y_.data(); }
+    };
+
+    namespace detail {
+        using AABBKernel = bool (*)(const AABB &, const AABBSoA &, uint64_t *);
+
+        inline bool intersectScalar(const AABB &query, const AABBSoA &boxes, uint64_t *mask) noexcept {
+            const float *min_x = boxes.minX(), *min_y = boxes.minY();
+            const float *max_x = boxes.maxX(), *max_y = boxes.maxY();
+            uint64_t any = 0;
+
+            for (size_t word = 0; word < boxes.maskWords(); ++word) {
+                const size_t begin = word * 64;
+                const size_t end = std::min(begin + 64, boxes.paddedSize());
+                uint64_t bits = 0;
+
+                for (size_t i = begin; i < end; ++i) {
+                    const bool hit = (query.max.x >= min_x[i]) & (query.min.x <= max_x[i]) &
+                                     (query.max.y >= min_y[i]) & (query.min.y <= max_y[i]);
+                    bits |= static_cast<uint64_t>(hit) << (i - begin);
+                }
+                mask[word] = bits;
+                any |= bits;
+            }
+            return any != 0;
+        }
+
+#ifdef CORE_COLLISION_X86
+        inline bool intersectSSE2(const AABB &query, const AABBSoA &boxes, uint64_t *mask) noexcept {
+            const __m128 q_min_x = _mm_set1_ps(query.min.x), q_min_y = _mm_set1_ps(query.min.y);
+            const __m128 q_max_x = _mm_set1_ps(query.max.x), q_max_y = _mm_set1_ps(query.max.y);
+            const float *min_x = boxes.minX(), *min_y = boxes.minY();
+            const float *max_x = boxes.maxX(), *max_y = boxes.maxY();
+            uint64_t any = 0;
+
+            for (size_t word = 0; word < boxes.maskWords(); ++word) {
+                const size_t begin = word * 64;
+                const size_t end = std::min(begin + 64, boxes.paddedSize());
+                uint64_t bits = 0;
+
+                for (size_t i = begin; i < end; i += 4) {
+                    __m128 hit = _mm_cmpge_ps(q_max_x, _mm_loadu_ps(min_x + i));
+                    hit = _mm_and_ps(hit, _mm_cmple_ps(q_min_x, _mm_loadu_ps(max_x + i)));
+                    hit = _mm_and_ps(hit, _mm_cmpge_ps(q_max_y, _mm_loadu_ps(min_y + i)));
+                    hit = _mm_and_ps(hit, _mm_cmple_ps(q_min_y, _mm_loadu_ps(max_y + i)));
+                    bits |= static_cast<uint64_t>(_mm_movemask_ps(hit)) << (i - begin);
+                }
+                mask[word] = bits;
+                any |= bits;
+            }
+            return any != 0;
+        }
+
+        __attribute__((target("avx2")))
+        inline bool intersectAVX2(const AABB &query, const AABBSoA &boxes, uint64_t *mask) noexcept {
+            const __m256 q_min_x = _mm256_set1_ps(query.min.x), q_min_y = _mm256_set1_ps(query.min.y);
+            const __m256 q_max_x = _mm256_set1_ps(query.max.x), q_max_y = _mm256_set1_ps(query.max.y);
+            const float *min_x = boxes.minX(), *min_y = boxes.minY();
+            const float *max_x = boxes.maxX(), *max_y = boxes.maxY();
+            uint64_t any = 0;
+
+            for (size_t word = 0; word < boxes.maskWords(); ++word) {
+                const size_t begin = word * 64;
+                const size_t end = std::min(begin + 64, boxes.paddedSize());
+                uint64_t bits = 0;
+
+                for (size_t i = begin; i < end; i += 8) {
+                    __m256 hit = _mm256_cmp_ps(q_max_x, _mm256_loadu_ps(min_x + i), _CMP_GE_OQ);
+                    hit = _mm256_and_ps(hit, _mm256_cmp_ps(q_min_x, _mm256_loadu_ps(max_x + i), _CMP_LE_OQ));
+                    hit = _mm256_and_ps(hit, _mm256_cmp_ps(q_max_y, _mm256_loadu_ps(min_y + i), _CMP_GE_OQ));
+                    hit = _mm256_and_ps(hit, _mm256_cmp_ps(q_min_y, _mm256_loadu_ps(max_y + i), _CMP_LE_OQ));
+                    bits |= static_cast<uint64_t>(_mm256_movemask_ps(hit)) << (i - begin);
+                }
+                mask[word] = bits;
+                any |= bits;
+            }
+            return any != 0;
+        }
+#endif
+
+        [[nodiscard]] inline AABBKernel kernelFor(const SimdLevel level) noexcept {
+            switch (level) {
+#ifdef CORE_COLLISION_X86
+                case SimdLevel::AVX2:
+                    return intersectAVX2;
+                case SimdLevel::SSE2:
+                    return intersectSSE2;
+#endif
+                default:
+                    return intersectScalar;
+            }
+        }
+    }
+
+    [[nodiscard]] inline SimdLevel detectSimdLevel() noexcept {
+#ifdef CORE_COLLISION_X86
+        static const SimdLevel level = [] {
+            __builtin_cpu_init();
+            if (__builtin_cpu_supports("avx2")) return SimdLevel::AVX2;
+            if (__builtin_cpu_supports("sse2")) return SimdLevel::SSE2;
+            return SimdLevel::Scalar;
+        }();
+        return level;
+#else
+        return SimdLevel::Scalar;
+#endif
+    }
+
+    // Tests one query box against every box in the array. Bit i of mask is set when box i
+    // intersects (touching counts, matching Rectangle::intersects); mask must hold
+    // boxes.maskWords() words. Returns whether anything was hit. Levels above what the CPU
+    // supports fall back to the detected one.
+    inline bool intersectBatch(const AABB &query, const AABBSoA &boxes, const std::span<uint64_t> mask,
+                               const SimdLevel level) noexcept {
+        const SimdLevel usable = std::min(level, detectSimdLevel());
+        return detail::kernelFor(usable)(query, boxes, mask.data());
+    }
+
+    inline bool intersectBatch(const AABB &query, const AABBSoA &boxes, const std::span<uint64_t> mask) noexcept {
+        static const detail::AABBKernel kernel = detail::kernelFor(detectSimdLevel());
+        return kernel(query, boxes, mask.data());
+    }
+
+    // Tests many queries at once; masks holds queries.size() consecutive rows of
+    // boxes.maskWords() words. Returns the number of queries that hit anything.
+    inline size_t intersectBatch(const std::span<const AABB> queries, const AABBSoA &boxes,
+                                 const std::span<uint64_t> masks) noexcept {
+        const size_t stride = boxes.maskWords();
+        size_t hits = 0;
+        for (size_t q = 0; q < queries.size(); ++q) {
+            hits += intersectBatch(queries[q], boxes, masks.subspan(q * stride, stride)) ? 1 : 0;
+        }
+        return hits;
+    }
+
+    // Index of the lowest set bit, or -1 if the mask is empty.
+    [[nodiscard]] inline std::ptrdiff_t firstHit(const std::span<const uint64_t> mask) noexcept {
+        for (size_t word = 0; word < mask.size(); ++word) {
+            if (mask[word] != 0) {
+                return static_cast<std::ptrdiff_t>(word * 64 + static_cast<size_t>(std::countr_zero(mask[word])));
+            }
+        }
+        return -1;
+    }
+
+    struct SweepHit {
+        size_t index{};
+        float time{};
+    };
+
+    // Time-of-impact order, ties by index. Hits are appended in index order, so std::sort
+    // with this gives what a stable sort would, without its temporary buffer each call.
+    inline bool earlierHit(const SweepHit &a, const SweepHit &b) noexcept {
+        return a.time < b.time || (a.time == b.time && a.index < b.index);
+    }
+
+    // Time of impact in [0, 1] of box moving by delta against a static target, found by
+    // casting the box center as a ray against the target grown by the box's half extents.
+    // Boxes already overlapping at the start report time 0.
+    [[nodiscard]] inline std::optional<float> sweep(const AABB &moving, const Vector2 delta, const AABB &target) noexcept {
+        const Vector2 half{(moving.max.x - moving.min.x) / 2, (moving.max.y - moving.min.y) / 2};
+        const Vector2 origin{moving.min.x + half.x, moving.min.y + half.y};
+        const AABB expanded{target.min - half, target.max + half};
+
+        float t_enter = 0.0f;
+        float t_exit = 1.0f;
+
+        const auto slab = [&](const float start, const float step, const float lo, const float hi) {
+            if (step == 0.0f) {
+                return start >= lo && start <= hi;
+            }
+            float t0 = (lo - start) / step;
+            float t1 = (hi - start) / step;
+            if (t0 > t1) std::swap(t0, t1);
+            t_enter = std::max(t_enter, t0);
+            t_exit = std::min(t_exit, t1);
+            return t_enter <= t_exit;
+        };
+
+        if (!slab(origin.x, delta.x, expanded.min.x, expanded.max.x) ||
+            !slab(origin.y, delta.y, expanded.min.y, expanded.max.y)) {
+            return std::nullopt;
+        }
+        return t_enter;
+    }
+
+    // Sweeps one box against every box in the array and appends the hits to hits in
+    // time-of-impact order (ties keep array order). The kernel culls against the swept
+    // box's bounds first, so only candidates pay for the slab test.
+    inline bool sweepBatch(const AABB &moving, const Vector2 delta, const AABBSoA &boxes,
+                           std::vector<uint64_t> &mask, std::vector<SweepHit> &hits) {
+        const AABB swept{
+            {std::min(moving.min.x, moving.min.x + delta.x), std::min(moving.min.y, moving.min.y + delta.y)},
+            {std::max(moving.max.x, moving.max.x + delta.x), std::max(moving.max.y, moving.max.y + delta.y)}
+        };
+
+        mask.resize(boxes.maskWords());
+        if (!intersectBatch(swept, boxes, mask)) return false;
+
+        const size_t first = hits.size();
+        for (size_t word = 0; word < mask.size(); ++word) {
+            for (uint64_t bits = mask[word]; bits != 0; bits &= bits - 1) {
+                const size_t index = word * 64 + static_cast<size_t>(std::countr_zero(bits));
+                if (const auto time = sweep(moving, delta, boxes.get(index))) {
+                    hits.push_back({index, *time});
+                }
+            }
+        }
+
+        std::sort(hits.begin() + static_cast<std::ptrdiff_t>(first), hits.end(), earlierHit);
+        return hits.size() > first;
+    }
+}
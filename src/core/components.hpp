@@ -0,0 +1,17 @@
+#pragma once
+#include "math.hpp"
+
+namespace core {
+    struct Transform {
+        Vector2 pos{};
+        Vector2 size{};
+
+        [[nodiscard]] constexpr AABB bounds() const noexcept {
+            return AABB::fromCenter(pos, size);
+        }
+    };
+
+    struct Velocity {
+        Vector2 value{};
+    };
+}
@@ -0,0 +1,405 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <cassert>
+#include <array>
+#include <algorithm>
+#include <tuple>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <latch>
+#include <vector>
+#include <functional>
+#include <type_traits>
+#include <unordered_map>
+#include "thread_pool.hpp"
+#include "alloc_tracker.hpp"
+
+namespace core::ecs {
+    using ComponentMask = uint64_t;
+    inline constexpr size_t MAX_COMPONENTS = 64;
+
+    namespace detail {
+        inline size_t nextComponentId() noexcept {
+            static std::atomic<size_t> next{0};
+            return next.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    // Dense per-type id. Components are plain data moved with memcpy when rows are
+    // compacted, so they must be trivially copyable. Empty tag types used purely as
+    // scheduler resources get ids the same way.
+    template<typename T>
+    [[nodiscard]] size_t componentId() noexcept {
+        static const size_t id = detail::nextComponentId();
+        assert(id < MAX_COMPONENTS && "too many component types");
+        return id;
+    }
+
+    template<typename... Ts>
+    [[nodiscard]] ComponentMask maskOf() noexcept {
+        return (ComponentMask{0} | ... | (ComponentMask{1} << componentId<std::remove_const_t<Ts> >()));
+    }
+
+    struct Entity {
+        uint32_t index{UINT32_MAX};
+        uint32_t generation{0};
+
+        constexpr bool operator==(const Entity &) const noexcept = default;
+
+        [[nodiscard]] constexpr bool valid() const noexcept { return index != UINT32_MAX; }
+    };
+
+    // All entities with exactly the same component set, one tightly packed column per
+    // component plus the owning entity handles, all indexed by row.
+    class Archetype {
+        struct Column {
+            size_t element_size{};
+            std::vector<std::byte> data;
+        };
+
+        ComponentMask mask_{};
+        std::vector<Entity> entities_;
+        std::vector<Column> columns_;
+        std::array<int8_t, MAX_COMPONENTS> column_of_{};
+
+    public:
+        Archetype(const ComponentMask mask, const std::array<size_t, MAX_COMPONENTS> &sizes) : mask_(mask) {
+            column_of_.fill(-1);
+            for (size_t id = 0; id < MAX_COMPONENTS; ++id) {
+                if (mask & (ComponentMask{1} << id)) {
+                    column_of_[id] = static_cast<int8_t>(columns_.size());
+                    columns_.push_back({sizes[id], {}});
+                }
+            }
+        }
+
+        [[nodiscard]] ComponentMask mask() const noexcept { return mask_; }
+        [[nodiscard]] size_t size() const noexcept { return entities_.size(); }
+        [[nodiscard]] const Entity *entities() const noexcept { return entities_.data(); }
+
+        template<typename T>
+        [[nodiscard]] T *column() noexcept {
+            const int8_t index = column_of_[componentId<std::remove_const_t<T> >()];
+            return reinterpret_cast<T *>(columns_[static_cast<size_t>(index)].data.data());
+        }
+
+        void reserve(const size_t rows) {
+            entities_.reserve(rows);
+            for (auto &column: columns_) {
+                column.data.reserve(rows * column.element_size);
+            }
+        }
+
+        size_t append(const Entity entity) {
+            entities_.push_back(entity);
+            for (auto &column: columns_) {
+                column.data.resize(column.data.size() + column.element_size);
+            }
+            return entities_.size() - 1;
+        }
+
+        template<typename T>
+        void write(const size_t row, const T &value) noexcept {
+            std::memcpy(column<T>() + row, &value, sizeof(T));
+        }
+
+        // Moves the last row into row and returns the entity that now lives there, or an
+        // invalid handle when row was the last one.
+        Entity swapRemove(const size_t row) noexcept {
+            const size_t last = entities_.size() - 1;
+            Entity moved{};
+            if (row != last) {
+                entities_[row] = entities_[last];
+                moved = entities_[row];
+                for (auto &column: columns_) {
+                    std::memcpy(column.data.data() + row * column.element_size,
+                                column.data.data() + last * column.element_size, column.element_size);
+                }
+            }
+            entities_.pop_back();
+            for (auto &column: columns_) {
+                column.data.resize(column.data.size() - column.element_size);
+            }
+            return moved;
+        }
+
+        void clear() noexcept {
+            entities_.clear();
+            for (auto &column: columns_) {
+                column.data.clear();
+            }
+        }
+    };
+
+    class World {
+        struct Location {
+            Archetype *archetype{};
+            uint32_t row{};
+            uint32_t generation{};
+        };
+
+        std::vector<std::unique_ptr<Archetype> > archetypes_;
+        std::unordered_map<ComponentMask, Archetype *> by_mask_;
+        std::array<size_t, MAX_COMPONENTS> component_sizes_{};
+        std::vector<Location> locations_;
+        std::vector<uint32_t> free_indices_;
+        std::mutex pending_mutex_;
+        std::vector<Entity> pending_destroy_;
+
+        template<typename... Ts>
+        Archetype &archetypeFor() {
+            const ComponentMask mask = maskOf<Ts...>();
+            if (const auto it = by_mask_.find(mask); it != by_mask_.end()) {
+                return *it->second;
+            }
+
+            ((component_sizes_[componentId<Ts>()] = sizeof(Ts)), ...);
+            archetypes_.push_back(std::make_unique<Archetype>(mask, component_sizes_));
+            by_mask_.emplace(mask, archetypes_.back().get());
+            return *archetypes_.back();
+        }
+
+        template<typename... Ts, typename Fn>
+        void forEachMatching(Fn &&fn) const {
+            const ComponentMask required = maskOf<Ts...>();
+            for (const auto &archetype: archetypes_) {
+                if ((archetype->mask() & required) == required && archetype->size() > 0) {
+                    fn(*archetype);
+                }
+            }
+        }
+
+    public:
+        template<typename... Ts>
+        Entity create(const Ts &... components) {
+            static_assert((std::is_trivially_copyable_v<Ts> && ...), "components must be trivially copyable");
+
+            Archetype &archetype = archetypeFor<Ts...>();
+
+            Entity entity;
+            if (!free_indices_.empty()) {
+                entity.index = free_indices_.back();
+                free_indices_.pop_back();
+            } else {
+                entity.index = static_cast<uint32_t>(locations_.size());
+                locations_.push_back({});
+            }
+            Location &location = locations_[entity.index];
+            entity.generation = location.generation;
+
+            const size_t row = archetype.append(entity);
+            (archetype.write(row, components), ...);
+
+            location.archetype = &archetype;
+            location.row = static_cast<uint32_t>(row);
+            return entity;
+        }
+
+        template<typename... Ts>
+        void reserve(const size_t count) {
+            archetypeFor<Ts...>().reserve(count);
+            locations_.reserve(locations_.size() + count);
+        }
+
+        [[nodiscard]] bool alive(const Entity entity) const noexcept {
+            return entity.index < locations_.size() &&
+                   locations_[entity.index].generation == entity.generation &&
+                   locations_[entity.index].archetype != nullptr;
+        }
+
+        void destroy(const Entity entity) {
+            if (!alive(entity)) return;
+
+            Location &location = locations_[entity.index];
+            if (const Entity moved = location.archetype->swapRemove(location.row); moved.valid()) {
+                locations_[moved.index].row = location.row;
+            }
+            location.archetype = nullptr;
+            ++location.generation;
+            free_indices_.push_back(entity.index);
+        }
+
+        // Safe to call from systems running in parallel; applied by flush().
+        void destroyLater(const Entity entity) {
+            std::lock_guard lock(pending_mutex_);
+            pending_destroy_.push_back(entity);
+        }
+
+        void flush() {
+            for (const Entity entity: pending_destroy_) {
+                destroy(entity);
+            }
+            pending_destroy_.clear();
+        }
+
+        void clear() {
+            for (const auto &archetype: archetypes_) {
+                for (size_t row = 0; row < archetype->size(); ++row) {
+                    const Entity entity = archetype->entities()[row];
+                    locations_[entity.index].archetype = nullptr;
+                    ++locations_[entity.index].generation;
+                    free_indices_.push_back(entity.index);
+                }
+                archetype->clear();
+            }
+            pending_destroy_.clear();
+        }
+
+        template<typename T>
+        [[nodiscard]] T *get(const Entity entity) noexcept {
+            if (!alive(entity)) return nullptr;
+
+            const Location &location = locations_[entity.index];
+            if (!(location.archetype->mask() & maskOf<T>())) return nullptr;
+            return location.archetype->column<T>() + location.row;
+        }
+
+        template<typename T>
+        [[nodiscard]] const T *get(const Entity entity) const noexcept {
+            if (!alive(entity)) return nullptr;
+
+            const Location &location = locations_[entity.index];
+            if (!(location.archetype->mask() & maskOf<T>())) return nullptr;
+            return location.archetype->column<T>() + location.row;
+        }
+
+        // Calls fn(Ts &...) or fn(Entity, Ts &...) for every entity that has all of Ts,
+        // walking each matching archetype's columns front to back.
+        template<typename... Ts, typename Fn>
+        void each(Fn &&fn) {
+            forEachMatching<Ts...>([&](Archetype &archetype) {
+                const size_t count = archetype.size();
+                const Entity *entities = archetype.entities();
+                auto columns = std::make_tuple(archetype.column<Ts>()...);
+
+                for (size_t row = 0; row < count; ++row) {
+                    if constexpr (std::is_invocable_v<Fn, Entity, Ts &...>) {
+                        fn(entities[row], std::get<Ts *>(columns)[row]...);
+                    } else {
+                        fn(std::get<Ts *>(columns)[row]...);
+                    }
+                }
+            });
+        }
+
+        // Read-only walk for a const world; every Ts must be const.
+        template<typename... Ts, typename Fn>
+        void each(Fn &&fn) const {
+            static_assert((std::is_const_v<Ts> && ...), "a const world only hands out const components");
+            const_cast<World *>(this)->each<Ts...>(std::forward<Fn>(fn));
+        }
+
+        // Calls fn(count, entities, Ts *...) once per matching archetype with its raw
+        // columns, for kernels that want to vectorize across rows.
+        template<typename... Ts, typename Fn>
+        void eachChunk(Fn &&fn) {
+            forEachMatching<Ts...>([&](Archetype &archetype) {
+                fn(archetype.size(), archetype.entities(), archetype.column<Ts>()...);
+            });
+        }
+
+        template<typename... Ts>
+        [[nodiscard]] size_t count() const {
+            size_t total = 0;
+            forEachMatching<Ts...>([&](const Archetype &archetype) { total += archetype.size(); });
+            return total;
+        }
+    };
+
+    // Declared component (or tag resource) access of a system, used to decide which
+    // systems may run concurrently.
+    struct Access {
+        ComponentMask reads{};
+        ComponentMask writes{};
+
+        template<typename... Ts>
+        Access &read() {
+            reads |= maskOf<Ts...>();
+            return *this;
+        }
+
+        template<typename... Ts>
+        Access &write() {
+            writes |= maskOf<Ts...>();
+            return *this;
+        }
+
+        [[nodiscard]] bool conflictsWith(const Access &other) const noexcept {
+            return (writes & (other.reads | other.writes)) != 0 || (other.writes & reads) != 0;
+        }
+    };
+
+    // Orders systems into stages: each system lands in the first stage after the last one
+    // holding a system it conflicts with, so conflicting systems keep their registration
+    // order while independent ones share a stage and run in parallel.
+    class Scheduler {
+        struct System {
+            const char *name;
+            Access access;
+            std::function<void(World &)> run;
+        };
+
+        struct StageContext {
+            World *world;
+            std::latch *done;
+            alloc::Tag tag;
+        };
+
+        std::vector<System> systems_;
+        std::vector<std::vector<size_t> > stages_;
+
+    public:
+        void add(const char *name, const Access access, std::function<void(World &)> run) {
+            size_t stage = 0;
+            for (size_t s = stages_.size(); s-- > 0;) {
+                const bool conflict = std::ranges::any_of(stages_[s], [&](const size_t other) {
+                    return systems_[other].access.conflictsWith(access);
+                });
+                if (conflict) {
+                    stage = s + 1;
+                    break;
+                }
+            }
+
+            systems_.push_back({name, access, std::move(run)});
+            if (stage == stages_.size()) {
+                stages_.emplace_back();
+            }
+            stages_[stage].push_back(systems_.size() - 1);
+        }
+
+        // Runs every stage in order; within a stage all but one system go to the pool and
+        // the calling thread takes the remaining one. Deferred destroys apply at the end.
+        void run(World &world, ThreadPool &pool) {
+            for (const auto &stage: stages_) {
+                if (stage.size() == 1 || pool.workerCount() == 0) {
+                    for (const size_t index: stage) {
+                        systems_[index].run(world);
+                    }
+                    continue;
+                }
+
+                std::latch done(static_cast<std::ptrdiff_t>(stage.size() - 1));
+                // Two pointers of capture fit std::function's inline storage, so handing a
+                // system to the pool does not allocate. Workers inherit the caller's
+                // allocation tag.
+                const StageContext context{&world, &done, alloc::currentTag()};
+                for (size_t i = 1; i < stage.size(); ++i) {
+                    pool.submit([system = &systems_[stage[i]], context = &context] {
+                        const alloc::Scope alloc_scope{context->tag};
+                        system->run(*context->world);
+                        context->done->count_down();
+                    });
+                }
+                systems_[stage[0]].run(world);
+                done.wait();
+            }
+            world.flush();
+        }
+
+        [[nodiscard]] size_t stageCount() const noexcept { return stages_.size(); }
+    };
+}
@@ -0,0 +1,125 @@
+#pragma once
+#include <memory_resource>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <charconv>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <cassert>
+
+namespace core {
+    // Strings and scratch vectors whose storage lives in a FrameArena.
+    using FrameString = std::pmr::string;
+    template<typename T>
+    using FrameVector = std::pmr::vector<T>;
+
+    // Bump allocator for data that only lives for one frame. Allocating moves a pointer,
+    // deallocating does nothing, and reset() reclaims the whole frame at once. A frame that
+    // outgrows the block spills to the heap; the block then grows to fit on the next reset,
+    // so steady-state frames never touch the general heap.
+    //
+    // Debug builds poison reclaimed memory and assert on reset when a frame allocation is
+    // still alive, which catches containers that escaped the frame that made them.
+    class FrameArena final : public std::pmr::memory_resource {
+        static constexpr size_t DEFAULT_CAPACITY = 64 * 1024;
+
+        std::unique_ptr<std::byte[]> block_;
+        size_t capacity_;
+        size_t used_{0};
+        size_t spilled_{0};
+        std::pmr::monotonic_buffer_resource overflow_{std::pmr::new_delete_resource()};
+#ifndef NDEBUG
+        size_t live_{0};
+#endif
+
+        void *do_allocate(const size_t bytes, const size_t alignment) override {
+#ifndef NDEBUG
+            ++live_;
+#endif
+            const auto base = reinterpret_cast<uintptr_t>(block_.get());
+            const uintptr_t aligned = (base + used_ + alignment - 1) & ~(uintptr_t{alignment} - 1);
+            if (const size_t end = aligned - base + bytes; end <= capacity_) {
+                used_ = end;
+                return reinterpret_cast<void *>(aligned);
+            }
+
+            spilled_ += bytes + alignment;
+            return overflow_.allocate(bytes, alignment);
+        }
+
+        void do_deallocate(void *, size_t, size_t) override {
+#ifndef NDEBUG
+            assert(live_ > 0 && "frame allocation released after its frame ended");
+            --live_;
+#endif
+        }
+
+        [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override {
+            return this == &other;
+        }
+
+        template<std::integral T>
+        static void append(FrameString &out, const T value) {
+            char digits[24];
+            const auto [end, error] = std::to_chars(digits, digits + sizeof(digits), value);
+            out.append(digits, end);
+        }
+
+        static void append(FrameString &out, const std::string_view text) {
+            out.append(text);
+        }
+
+    public:
+        // Resets the arena when it goes out of scope, i.e. at the end of a frame.
+        class Scope {
+            FrameArena &arena_;
+
+        public:
+            explicit Scope(FrameArena &arena) noexcept : arena_(arena) {}
+
+            ~Scope() { arena_.reset(); }
+
+            Scope(const Scope &) = delete;
+
+            Scope &operator=(const Scope &) = delete;
+        };
+
+        explicit FrameArena(const size_t capacity = DEFAULT_CAPACITY)
+            : block_(std::make_unique<std::byte[]>(capacity)), capacity_(capacity) {
+        }
+
+        FrameArena(const FrameArena &) = delete;
+
+        FrameArena &operator=(const FrameArena &) = delete;
+
+        // Reclaims everything allocated since the last reset.
+        void reset() {
+#ifndef NDEBUG
+            assert(live_ == 0 && "frame allocation escaped its frame");
+            std::memset(block_.get(), 0xdd, used_);
+#endif
+            if (spilled_ > 0) {
+                overflow_.release();
+                capacity_ += spilled_;
+                block_ = std::make_unique<std::byte[]>(capacity_);
+                spilled_ = 0;
+            }
+            used_ = 0;
+        }
+
+        // Concatenates string pieces and integers into a string allocated from this frame.
+        template<typename... Parts>
+        [[nodiscard]] FrameString concat(const Parts &... parts) {
+            FrameString out{this};
+            (append(out, parts), ...);
+            return out;
+        }
+
+        [[nodiscard]] size_t used() const noexcept { return used_; }
+        [[nodiscard]] size_t capacity() const noexcept { return capacity_; }
+    };
+}
@@ -1,8 +1,14 @@
 #pragma once
+#include <memory>
 
 namespace core {
     class Renderer;
     class InputManager;
+    class InputSource;
+    class StateWriter;
+    class StateReader;
+    class StateHash;
+    class Random;
 }
 
 namespace games {
@@ -23,8 +29,39 @@ namespace games {
 
         [[nodiscard]] virtual GameState getState() const = 0;
 
+        // Freezes a game in progress; render keeps drawing the frozen state.
+        virtual void setPaused(bool paused) = 0;
+
         virtual void reset() = 0;
 
+        // Replaces the game's generator, so the reset() after it starts the same round a
+        // freshly constructed game would.
+        virtual void reseed(const core::Random &random) = 0;
+
         [[nodiscard]] virtual const char *getName() const = 0;
+
+        // Plays the game unattended (--autoplay) by reading its state each update. The
+        // source must not outlive the game; null when the game has no bot.
+        [[nodiscard]] virtual std::unique_ptr<core::InputSource> createAutopilot() const {
+            return nullptr;
+        }
+
+        // Replay keyframes: everything update() depends on, so a loaded game carries on
+        // exactly as the saved one did. Effects such as particles are left out. Games
+        // that cannot be recorded return false.
+        [[nodiscard]] virtual bool saveState(core::StateWriter &) const {
+            return false;
+        }
+
+        [[nodiscard]] virtual bool loadState(core::StateReader &) {
+            return false;
+        }
+
+        // Determinism checks (--hash-log) hash this after every tick, so it must stay a
+        // small fraction of one: positions, scores and generator state go in directly,
+        // large collections through digests kept up to date as they change. Equal
+        // hashes from two builds mean the runs have not visibly diverged.
+        virtual void hashState(core::StateHash &) const {
+        }
     };
 }
\ No newline at end of file
@@ -0,0 +1,92 @@
+#pragma once
+#include "game.hpp"
+#include "random.hpp"
+#include <cstdint>
+#include <vector>
+#include <memory>
+#include <functional>
+#include <string>
+
+namespace games {
+    // Catalog of games known by name and factory only. A game is constructed the first
+    // time it is started and destroyed again once it has sat unused for the idle
+    // timeout, so startup cost and resident memory do not grow with the catalog.
+    // Each game gets its own stream of the session seed, so what one game draws never
+    // depends on which others were played.
+    class GameRegistry {
+        struct Entry {
+            std::string name;
+            core::Random random;
+            std::function<std::unique_ptr<Game>()> factory;
+            std::unique_ptr<Game> instance;
+            float idle_time{0.0f};
+        };
+
+        std::vector<Entry> entries_;
+        float idle_timeout_;
+        uint64_t seed_;
+
+    public:
+        // A timeout of zero keeps games resident once loaded.
+        explicit GameRegistry(const float idle_timeout = 30.0f, const uint64_t seed = 0)
+            : idle_timeout_(idle_timeout), seed_(seed) {
+        }
+
+        // T is constructed from its generator followed by args. Both are copied and reused
+        // whenever the game is constructed again, so a reloaded game starts over.
+        template<typename T, typename... Args>
+        void add(std::string name, Args... args) {
+            const core::Random random{seed_, entries_.size()};
+            entries_.push_back({std::move(name), random, [random, args...] { return std::make_unique<T>(random, args...); }, nullptr});
+        }
+
+        // Returns a game ready to play: freshly constructed on first use, reseeded and reset
+        // otherwise. Either way it starts from its stream's beginning, so a seed repeats a
+        // session however long the menu sat idle or how many rounds came before.
+        Game &start(const size_t index) {
+            Entry &entry = entries_[index];
+            entry.idle_time = 0.0f;
+            if (entry.instance) {
+                entry.instance->reseed(entry.random);
+                entry.instance->reset();
+            } else {
+                entry.instance = entry.factory();
+            }
+            return *entry.instance;
+        }
+
+        // Ages every loaded game except the active one and unloads those past the timeout.
+        void collectIdle(const float dt, const size_t active_index) {
+            for (size_t i = 0; i < entries_.size(); ++i) {
+                Entry &entry = entries_[i];
+                if (!entry.instance) continue;
+
+                if (i == active_index) {
+                    entry.idle_time = 0.0f;
+                    continue;
+                }
+
+                entry.idle_time += dt;
+                if (idle_timeout_ > 0.0f && entry.idle_time >= idle_timeout_) {
+                    entry.instance.reset();
+                }
+            }
+        }
+
+        [[nodiscard]] Game *get(const size_t index) const noexcept {
+            return index < entries_.size() ? entries_[index].instance.get() : nullptr;
+        }
+
+        [[nodiscard]] const std::string &getName(const size_t index) const noexcept {
+            return entries_[index].name;
+        }
+
+        [[nodiscard]] bool isLoaded(const size_t index) const noexcept {
+            return entries_[index].instance != nullptr;
+        }
+
+        [[nodiscard]] size_t size() const noexcept {
+            return entries_.size();
+        }
+    };
+}
@@ -0,0 +1,288 @@
+#pragma once
+#include <SDL2/SDL.h>
+#include <GL/gl.h>
+#include <GL/glu.h>
+#ifndef GL_CLAMP_TO_EDGE
+#define GL_CLAMP_TO_EDGE 0x812F
+#endif
+#include <string_view>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include "render_backend.hpp"
+#include "gl_state.hpp"
+
+namespace core {
+    // Each draw sets the full state it needs through the state cache, so results never
+    // depend on what was drawn before: blending stays on, texturing is enabled only for
+    // images and text, and the current color is reapplied after an image overrode it.
+    class GLRenderBackend final : public RenderBackend {
+        SDL_Window *window_{};
+        SDL_GLContext context_{};
+        int width_{}, height_{};
+        GLStateCache state_;
+        GLuint image_texture_{0};
+        GLuint glyph_texture_{0};
+        float texel_u_{0.0f}, texel_v_{0.0f};
+        float r_{1.0f}, g_{1.0f}, b_{1.0f}, a_{1.0f};
+        StateCallStats last_frame_{};
+        std::vector<float> quad_vertices_;
+        std::vector<Uint8> quad_colors_;
+        std::vector<float> glyph_tex_coords_;
+
+        void beginShapes() noexcept {
+            state_.setEnabled(GL_TEXTURE_2D, false);
+            state_.setColor(r_, g_, b_, a_);
+        }
+
+    public:
+        GLRenderBackend(const std::string_view title, const int width, const int height)
+            : width_(width), height_(height) {
+            SDL_GL_SetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, 2);
+            SDL_GL_SetAttribute(SDL_GL_CONTEXT_MINOR_VERSION, 1);
+
+            window_ = SDL_CreateWindow(title.data(),
+                                       SDL_WINDOWPOS_CENTERED,
+                                       SDL_WINDOWPOS_CENTERED,
+                                       width, height,
+                                       SDL_WINDOW_OPENGL);
+            if (!window_) {
+                throw std::runtime_error("Failed to create window: " + std::string(SDL_GetError()));
+            }
+
+            context_ = SDL_GL_CreateContext(window_);
+            if (!context_) {
+                SDL_DestroyWindow(window_);
+                throw std::runtime_error("Failed to create GL context: " + std::string(SDL_GetError()));
+            }
+
+            glViewport(0, 0, width, height);
+            glMatrixMode(GL_PROJECTION);
+            glLoadIdentity();
+            gluOrtho2D(0, width, 0, height);
+            glMatrixMode(GL_MODELVIEW);
+            glLoadIdentity();
+
+            state_.setEnabled(GL_BLEND, true);
+            state_.setBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+            // One texture is reused for every image upload.
+            glGenTextures(1, &image_texture_);
+            state_.bindTexture(image_texture_);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        }
+
+        ~GLRenderBackend() override {
+            if (image_texture_) {
+                state_.forgetTexture(image_texture_);
+                glDeleteTextures(1, &image_texture_);
+            }
+            if (glyph_texture_) {
+                state_.forgetTexture(glyph_texture_);
+                glDeleteTextures(1, &glyph_texture_);
+            }
+            if (context_) SDL_GL_DeleteContext(context_);
+            if (window_) SDL_DestroyWindow(window_);
+        }
+
+        GLRenderBackend(const GLRenderBackend &) = delete;
+
+        GLRenderBackend &operator=(const GLRenderBackend &) = delete;
+
+        void clear(const float r, const float g, const float b) override {
+            state_.setClearColor(r, g, b, 1.0f);
+            glClear(GL_COLOR_BUFFER_BIT);
+        }
+
+        void setColor(const float r, const float g, const float b, const float a) override {
+            r_ = r;
+            g_ = g;
+            b_ = b;
+            a_ = a;
+        }
+
+        void setTranslation(const float x, const float y) override {
+            state_.setTranslation(x, y);
+        }
+
+        void drawRect(const float x, const float y, const float w, const float h) override {
+            beginShapes();
+            glBegin(GL_QUADS);
+            glVertex2f(x - w / 2, y - h / 2);
+            glVertex2f(x + w / 2, y - h / 2);
+            glVertex2f(x + w / 2, y + h / 2);
+            glVertex2f(x - w / 2, y + h / 2);
+            glEnd();
+        }
+
+        void drawCircle(const float x, const float y, const float radius, const int segments) override {
+            beginShapes();
+            glBegin(GL_TRIANGLE_FAN);
+            glVertex2f(x, y);
+
+            for (int i = 0; i <= segments; ++i) {
+                const auto angle = static_cast<float>(2.0f * std::acos(-1.0) * i / segments);
+                glVertex2f(x + radius * std::cos(angle), y + radius * std::sin(angle));
+            }
+            glEnd();
+        }
+
+        // Expands the batch into client vertex and color arrays and draws it with a
+        // single glDrawArrays.
+        void drawQuads(const std::span<const Quad> quads) override {
+            if (quads.empty()) return;
+
+            quad_vertices_.resize(quads.size() * 8);
+            quad_colors_.resize(quads.size() * 16);
+            float *vertex = quad_vertices_.data();
+            Uint8 *color = quad_colors_.data();
+            for (const Quad &quad: quads) {
+                const float half = quad.size / 2;
+                const float left = quad.x - half, right = quad.x + half;
+                const float bottom = quad.y - half, top = quad.y + half;
+                const float corners[8] = {left, bottom, right, bottom, right, top, left, top};
+                std::copy_n(corners, 8, vertex);
+                vertex += 8;
+                for (int corner = 0; corner < 4; ++corner) {
+                    *color++ = quad.r;
+                    *color++ = quad.g;
+                    *color++ = quad.b;
+                    *color++ = quad.a;
+                }
+            }
+
+            state_.setEnabled(GL_TEXTURE_2D, false);
+            glEnableClientState(GL_VERTEX_ARRAY);
+            glEnableClientState(GL_COLOR_ARRAY);
+            glVertexPointer(2, GL_FLOAT, 0, quad_vertices_.data());
+            glColorPointer(4, GL_UNSIGNED_BYTE, 0, quad_colors_.data());
+            glDrawArrays(GL_QUADS, 0, static_cast<GLsizei>(quads.size() * 4));
+            glDisableClientState(GL_COLOR_ARRAY);
+            glDisableClientState(GL_VERTEX_ARRAY);
+            state_.forgetColor();
+        }
+
+        void drawImage(const ImageView &image, const float x, const float y,
+                       const float alpha, const bool nearest) override {
+            state_.bindTexture(image_texture_);
+            state_.setTextureFilter(nearest ? GL_NEAREST : GL_LINEAR);
+
+            glPixelStorei(GL_UNPACK_ROW_LENGTH, image.pitch / 4);
+            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, image.width, image.height,
+                         0, GL_RGBA, GL_UNSIGNED_BYTE, image.pixels);
+            glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+
+            state_.setEnabled(GL_TEXTURE_2D, true);
+            state_.setColor(1.0f, 1.0f, 1.0f, alpha);
+
+            const auto width = static_cast<float>(image.width);
+            const auto height = static_cast<float>(image.height);
+
+            glBegin(GL_QUADS);
+            glTexCoord2f(0.0f, 1.0f);
+            glVertex2f(x, y);
+            glTexCoord2f(1.0f, 1.0f);
+            glVertex2f(x + width, y);
+            glTexCoord2f(1.0f, 0.0f);
+            glVertex2f(x + width, y + height);
+            glTexCoord2f(0.0f, 0.0f);
+            glVertex2f(x, y + height);
+            glEnd();
+        }
+
+        // Uploaded once as an alpha texture; with GL_MODULATE each vertex color tints its
+        // glyph and the coverage scales the alpha.
+        void setGlyphAtlas(const GlyphAtlas &atlas) override {
+            if (!glyph_texture_) glGenTextures(1, &glyph_texture_);
+            state_.bindTexture(glyph_texture_);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+            glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+            glTexImage2D(GL_TEXTURE_2D, 0, GL_ALPHA, atlas.width, atlas.height,
+                         0, GL_ALPHA, GL_UNSIGNED_BYTE, atlas.coverage);
+            glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+            texel_u_ = 1.0f / static_cast<float>(atlas.width);
+            texel_v_ = 1.0f / static_cast<float>(atlas.height);
+        }
+
+        // Same client arrays as drawQuads plus texture coordinates, under one atlas bind.
+        void drawGlyphs(const std::span<const GlyphQuad> glyphs) override {
+            if (glyphs.empty()) return;
+
+            quad_vertices_.resize(glyphs.size() * 8);
+            glyph_tex_coords_.resize(glyphs.size() * 8);
+            quad_colors_.resize(glyphs.size() * 16);
+            float *vertex = quad_vertices_.data();
+            float *tex_coord = glyph_tex_coords_.data();
+            Uint8 *color = quad_colors_.data();
+            for (const GlyphQuad &glyph: glyphs) {
+                const float left = glyph.x, right = glyph.x + glyph.w;
+                const float bottom = glyph.y, top = glyph.y + glyph.h;
+                const float u0 = glyph.u * texel_u_, u1 = (glyph.u + glyph.w) * texel_u_;
+                const float v0 = glyph.v * texel_v_, v1 = (glyph.v + glyph.h) * texel_v_;
+                const float corners[8] = {left, bottom, right, bottom, right, top, left, top};
+                const float coords[8] = {u0, v1, u1, v1, u1, v0, u0, v0};
+                std::copy_n(corners, 8, vertex);
+                std::copy_n(coords, 8, tex_coord);
+                vertex += 8;
+                tex_coord += 8;
+                for (int corner = 0; corner < 4; ++corner) {
+                    *color++ = glyph.r;
+                    *color++ = glyph.g;
+                    *color++ = glyph.b;
+                    *color++ = glyph.a;
+                }
+            }
+
+            state_.bindTexture(glyph_texture_);
+            state_.setTextureFilter(GL_NEAREST);
+            state_.setEnabled(GL_TEXTURE_2D, true);
+            glEnableClientState(GL_VERTEX_ARRAY);
+            glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+            glEnableClientState(GL_COLOR_ARRAY);
+            glVertexPointer(2, GL_FLOAT, 0, quad_vertices_.data());
+            glTexCoordPointer(2, GL_FLOAT, 0, glyph_tex_coords_.data());
+            glColorPointer(4, GL_UNSIGNED_BYTE, 0, quad_colors_.data());
+            glDrawArrays(GL_QUADS, 0, static_cast<GLsizei>(glyphs.size() * 4));
+            glDisableClientState(GL_COLOR_ARRAY);
+            glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+            glDisableClientState(GL_VERTEX_ARRAY);
+            state_.forgetColor();
+        }
+
+        // GL reads bottom-up; the rows are flipped in place so a reused rgb buffer is the
+        // only storage a capture needs.
+        bool readPixels(std::vector<Uint8> &rgb) override {
+            const auto row_bytes = static_cast<size_t>(width_) * 3;
+            rgb.resize(row_bytes * static_cast<size_t>(height_));
+
+            glPixelStorei(GL_PACK_ALIGNMENT, 1);
+            glReadBuffer(GL_BACK);
+            glReadPixels(0, 0, width_, height_, GL_RGB, GL_UNSIGNED_BYTE, rgb.data());
+
+            for (int top = 0, bottom = height_ - 1; top < bottom; ++top, --bottom) {
+                Uint8 *upper = rgb.data() + static_cast<size_t>(top) * row_bytes;
+                std::swap_ranges(upper, upper + row_bytes, rgb.data() + static_cast<size_t>(bottom) * row_bytes);
+            }
+            return true;
+        }
+
+        void present() override {
+            SDL_GL_SwapWindow(window_);
+            last_frame_ = state_.endFrame();
+        }
+
+        [[nodiscard]] RenderBackendKind kind() const noexcept override {
+            return RenderBackendKind::OpenGL;
+        }
+
+        [[nodiscard]] StateCallStats stateCalls() const noexcept override {
+            return last_frame_;
+        }
+    };
+}
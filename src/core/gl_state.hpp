@@ -0,0 +1,112 @@
+#pragma once
+#include "render_backend.hpp"
+#include <GL/gl.h>
+#include <array>
+
+namespace core {
+    // Shadow of the fixed-function state the GL backend touches, starting from the
+    // context defaults. Every change goes through here and is dropped when GL already
+    // holds that value.
+    class GLStateCache {
+        bool blend_{false};
+        bool texture_2d_{false};
+        GLenum blend_src_{GL_ONE}, blend_dst_{GL_ZERO};
+        GLuint texture_{0};
+        GLint texture_filter_{-1};
+        std::array<float, 4> color_{1.0f, 1.0f, 1.0f, 1.0f};
+        std::array<float, 4> clear_color_{0.0f, 0.0f, 0.0f, 0.0f};
+        float translate_x_{0.0f}, translate_y_{0.0f};
+        StateCallStats frame_{};
+
+        bool apply(const bool changed) noexcept {
+            if (changed) {
+                ++frame_.issued;
+            } else {
+                ++frame_.skipped;
+            }
+            return changed;
+        }
+
+    public:
+        void setEnabled(const GLenum capability, const bool enabled) noexcept {
+            bool &current = capability == GL_BLEND ? blend_ : texture_2d_;
+            if (!apply(current != enabled)) return;
+
+            current = enabled;
+            if (enabled) {
+                glEnable(capability);
+            } else {
+                glDisable(capability);
+            }
+        }
+
+        void setBlendFunc(const GLenum src, const GLenum dst) noexcept {
+            if (!apply(src != blend_src_ || dst != blend_dst_)) return;
+
+            blend_src_ = src;
+            blend_dst_ = dst;
+            glBlendFunc(src, dst);
+        }
+
+        void bindTexture(const GLuint texture) noexcept {
+            if (!apply(texture != texture_)) return;
+
+            texture_ = texture;
+            texture_filter_ = -1;
+            glBindTexture(GL_TEXTURE_2D, texture);
+        }
+
+        // Min/mag filter of the bound texture.
+        void setTextureFilter(const GLint filter) noexcept {
+            if (!apply(filter != texture_filter_)) return;
+
+            texture_filter_ = filter;
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, filter);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, filter);
+        }
+
+        void setColor(const float r, const float g, const float b, const float a) noexcept {
+            if (!apply(color_ != std::array{r, g, b, a})) return;
+
+            color_ = {r, g, b, a};
+            glColor4f(r, g, b, a);
+        }
+
+        void setClearColor(const float r, const float g, const float b, const float a) noexcept {
+            if (!apply(clear_color_ != std::array{r, g, b, a})) return;
+
+            clear_color_ = {r, g, b, a};
+            glClearColor(r, g, b, a);
+        }
+
+        // Modelview is only ever a translation.
+        void setTranslation(const float x, const float y) noexcept {
+            if (!apply(x != translate_x_ || y != translate_y_)) return;
+
+            translate_x_ = x;
+            translate_y_ = y;
+            glLoadIdentity();
+            glTranslatef(x, y, 0.0f);
+        }
+
+        // Client color arrays leave the current color undefined; the next setColor reissues.
+        void forgetColor() noexcept {
+            color_ = {-1.0f, -1.0f, -1.0f, -1.0f};
+        }
+
+        // Texture deletion unbinds it in GL; keep the shadow in step.
+        void forgetTexture(const GLuint texture) noexcept {
+            if (texture_ == texture) {
+                texture_ = 0;
+                texture_filter_ = -1;
+            }
+        }
+
+        // Returns this frame's counts and starts a new frame.
+        StateCallStats endFrame() noexcept {
+            const StateCallStats frame = frame_;
+            frame_ = {};
+            return frame;
+        }
+    };
+}
@@ -1,15 +1,39 @@
 #pragma once
 #include <SDL2/SDL.h>
+#include <cstdlib>
+#include <memory>
 
 namespace core {
-    class InputManager {
+    // The controls the menu and games read, sampled once per update.
+    struct InputState {
+        float horizontal{0.0f};
+        bool shoot{false};
+        bool up{false};
+        bool down{false};
+        bool escape{false};
+        bool pause{false};
+    };
+
+    // Somewhere controls come from besides the player, such as an autoplay bot. A source
+    // overwrites only the controls it drives; the rest keep what the devices reported.
+    class InputSource {
+    public:
+        virtual ~InputSource() = default;
+
+        virtual void sample(InputState &state) = 0;
+    };
+
+    // Keyboard and the first game controller.
+    class DeviceInput final : public InputSource {
         const Uint8 *keyboard_state_{};
         SDL_GameController *controller_{};
-        bool prev_shoot_pressed_{false};
-        bool curr_shoot_pressed_{false};
+
+        [[nodiscard]] bool button(const SDL_GameControllerButton button) const noexcept {
+            return controller_ && SDL_GameControllerGetButton(controller_, button);
+        }
 
     public:
-        InputManager() {
+        DeviceInput() {
             keyboard_state_ = SDL_GetKeyboardState(nullptr);
 
             for (int i = 0; i < SDL_NumJoysticks(); ++i) {
@@ -20,73 +44,139 @@ namespace core {
             }
         }
 
-        ~InputManager() {
+        ~DeviceInput() override {
             if (controller_) {
                 SDL_GameControllerClose(controller_);
             }
         }
 
+        DeviceInput(const DeviceInput &) = delete;
+
+        DeviceInput &operator=(const DeviceInput &) = delete;
+
+        void sample(InputState &state) override {
+            state.shoot = keyboard_state_[SDL_SCANCODE_SPACE] ||
+                          keyboard_state_[SDL_SCANCODE_UP] ||
+                          keyboard_state_[SDL_SCANCODE_RETURN] ||
+                          button(SDL_CONTROLLER_BUTTON_A);
+
+            state.horizontal = 0.0f;
+            if (keyboard_state_[SDL_SCANCODE_LEFT] || keyboard_state_[SDL_SCANCODE_A]) {
+                state.horizontal -= 1.0f;
+            }
+            if (keyboard_state_[SDL_SCANCODE_RIGHT] || keyboard_state_[SDL_SCANCODE_D]) {
+                state.horizontal += 1.0f;
+            }
+            if (controller_) {
+                if (const Sint16 controller_axis = SDL_GameControllerGetAxis(controller_, SDL_CONTROLLER_AXIS_LEFTX); std::abs(controller_axis) > 8000) {
+                    state.horizontal = static_cast<float>(controller_axis) / 32767.0f;
+                }
+            }
+
+            state.up = keyboard_state_[SDL_SCANCODE_UP] || keyboard_state_[SDL_SCANCODE_W] ||
+                       button(SDL_CONTROLLER_BUTTON_DPAD_UP);
+            state.down = keyboard_state_[SDL_SCANCODE_DOWN] || keyboard_state_[SDL_SCANCODE_S] ||
+                         button(SDL_CONTROLLER_BUTTON_DPAD_DOWN);
+            state.escape = keyboard_state_[SDL_SCANCODE_ESCAPE] || button(SDL_CONTROLLER_BUTTON_Y);
+            state.pause = keyboard_state_[SDL_SCANCODE_P] || button(SDL_CONTROLLER_BUTTON_START);
+        }
+
+        [[nodiscard]] bool isKeyPressed(const SDL_Scancode key) const noexcept {
+            return keyboard_state_[key];
+        }
+
+        [[nodiscard]] bool hasController() const noexcept {
+            return controller_ != nullptr;
+        }
+    };
+
+    // Devices are always read, so Escape and pause keep working while a source such as
+    // an autoplay bot drives the game.
+    class InputManager {
+        DeviceInput devices_;
+        std::unique_ptr<InputSource> source_;
+        InputState previous_{};
+        InputState current_{};
+
+    public:
+        InputManager() = default;
+
         InputManager(const InputManager &) = delete;
 
         InputManager &operator=(const InputManager &) = delete;
 
         void update() {
-            prev_shoot_pressed_ = curr_shoot_pressed_;
+            previous_ = current_;
+            devices_.sample(current_);
+            if (source_) {
+                source_->sample(current_);
+            }
+        }
+
+        // Layers a source over the devices from the next update; null returns to devices only.
+        void setSource(std::unique_ptr<InputSource> source) noexcept {
+            source_ = std::move(source);
+        }
+
+        [[nodiscard]] bool hasSource() const noexcept {
+            return source_ != nullptr;
+        }
+
+        // Replaces the controls games read with recorded ones, keeping what the devices
+        // last reported for Escape and pause.
+        void replay(const InputState &previous, const InputState &current) noexcept {
+            const auto drive = [](InputState &state, const InputState &recorded) {
+                state.horizontal = recorded.horizontal;
+                state.shoot = recorded.shoot;
+                state.up = recorded.up;
+                state.down = recorded.down;
+            };
+            drive(previous_, previous);
+            drive(current_, current);
+        }
+
+        [[nodiscard]] const InputState &state() const noexcept {
+            return current_;
+        }
 
-            curr_shoot_pressed_ = keyboard_state_[SDL_SCANCODE_SPACE] ||
-                                  keyboard_state_[SDL_SCANCODE_UP] ||
-                                  keyboard_state_[SDL_SCANCODE_RETURN] ||
-                                  (controller_ && SDL_GameControllerGetButton(controller_, SDL_CONTROLLER_BUTTON_A));
+        [[nodiscard]] const InputState &previousState() const noexcept {
+            return previous_;
         }
 
         [[nodiscard]] bool isKeyPressed(const SDL_Scancode key) const noexcept {
-            return keyboard_state_[key];
+            return devices_.isKeyPressed(key);
         }
 
         [[nodiscard]] bool isShootJustPressed() const noexcept {
-            return curr_shoot_pressed_ && !prev_shoot_pressed_;
+            return current_.shoot && !previous_.shoot;
         }
 
         [[nodiscard]] bool isShootPressed() const noexcept {
-            return curr_shoot_pressed_;
+            return current_.shoot;
         }
 
         [[nodiscard]] float getHorizontalAxis() const noexcept {
-            float axis = 0.0f;
-
-            if (keyboard_state_[SDL_SCANCODE_LEFT] || keyboard_state_[SDL_SCANCODE_A]) {
-                axis -= 1.0f;
-            }
-            if (keyboard_state_[SDL_SCANCODE_RIGHT] || keyboard_state_[SDL_SCANCODE_D]) {
-                axis += 1.0f;
-            }
-
-            if (controller_) {
-                if (const Sint16 controller_axis = SDL_GameControllerGetAxis(controller_, SDL_CONTROLLER_AXIS_LEFTX); std::abs(controller_axis) > 8000) {
-                    axis = static_cast<float>(controller_axis) / 32767.0f;
-                }
-            }
-
-            return axis;
+            return current_.horizontal;
         }
 
         [[nodiscard]] bool isUpPressed() const noexcept {
-            return keyboard_state_[SDL_SCANCODE_UP] || keyboard_state_[SDL_SCANCODE_W] ||
-                   (controller_ && SDL_GameControllerGetButton(controller_, SDL_CONTROLLER_BUTTON_DPAD_UP));
+            return current_.up;
         }
 
         [[nodiscard]] bool isDownPressed() const noexcept {
-            return keyboard_state_[SDL_SCANCODE_DOWN] || keyboard_state_[SDL_SCANCODE_S] ||
-                   (controller_ && SDL_GameControllerGetButton(controller_, SDL_CONTROLLER_BUTTON_DPAD_DOWN));
+            return current_.down;
         }
 
         [[nodiscard]] bool isEscapePressed() const noexcept {
-            return keyboard_state_[SDL_SCANCODE_ESCAPE] ||
-                   (controller_ && SDL_GameControllerGetButton(controller_, SDL_CONTROLLER_BUTTON_Y));
+            return current_.escape;
+        }
+
+        [[nodiscard]] bool isPausePressed() const noexcept {
+            return current_.pause;
         }
 
         [[nodiscard]] bool hasController() const noexcept {
-            return controller_ != nullptr;
+            return devices_.hasController();
         }
     };
 }
@@ -20,6 +20,10 @@ namespace core {
             return *this;
         }
 
+        constexpr Vector2 operator-(const Vector2 &other) const noexcept {
+            return {x - other.x, y - other.y};
+        }
+
         constexpr Vector2 operator*(const float scalar) const noexcept {
             return {x * scalar, y * scalar};
         }
@@ -44,6 +48,29 @@ namespace core {
         }
     };
 
+    struct AABB {
+        Vector2 min{};
+        Vector2 max{};
+
+        constexpr AABB() = default;
+
+        constexpr AABB(const Vector2 min, const Vector2 max) : min(min), max(max) {
+        }
+
+        [[nodiscard]] static constexpr AABB fromCenter(const Vector2 center, const Vector2 size) noexcept {
+            return {{center.x - size.x / 2, center.y - size.y / 2}, {center.x + size.x / 2, center.y + size.y / 2}};
+        }
+
+        [[nodiscard]] constexpr AABB translated(const Vector2 offset) const noexcept {
+            return {min + offset, max + offset};
+        }
+
+        [[nodiscard]] constexpr bool intersects(const AABB &other) const noexcept {
+            return max.x >= other.min.x && min.x <= other.max.x &&
+                   max.y >= other.min.y && min.y <= other.max.y;
+        }
+    };
+
     struct Rectangle {
         Vector2 pos{};
         Vector2 size{};
@@ -58,6 +85,10 @@ namespace core {
                    point.y >= pos.y - size.y / 2 && point.y <= pos.y + size.y / 2;
         }
 
+        [[nodiscard]] constexpr AABB bounds() const noexcept {
+            return AABB::fromCenter(pos, size);
+        }
+
         [[nodiscard]] constexpr bool intersects(const Rectangle &other) const noexcept {
             return !(pos.x + size.x / 2 < other.pos.x - other.size.x / 2 ||
                      pos.x - size.x / 2 > other.pos.x + other.size.x / 2 ||
@@ -0,0 +1,239 @@
+#pragma once
+#include <atomic>
+#include <array>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <algorithm>
+#include <utility>
+#include <cerrno>
+#include <string>
+#include <string_view>
+#include <stdexcept>
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#define HAS_METRICS_PAGE 1
+#endif
+
+namespace core::metrics {
+#ifdef HAS_METRICS_PAGE
+    inline constexpr bool PAGE_AVAILABLE = true;
+#else
+    inline constexpr bool PAGE_AVAILABLE = false;
+#endif
+
+    inline constexpr uint32_t MAGIC = 0x52474D50; // "RGMP"
+    inline constexpr uint32_t VERSION = 2;
+
+    // Frame-time histogram: bucket i counts frames shorter than BUCKET_BASE_US << i, the
+    // last bucket everything longer.
+    inline constexpr size_t HISTOGRAM_BUCKETS = 12;
+    inline constexpr uint32_t BUCKET_BASE_US = 500;
+
+    inline constexpr size_t GAME_NAME_WORDS = 4;
+
+    // Shared-memory layout, read by tools/metrics_reader.cpp. Everything after the header
+    // is guarded by a seqlock: the writer makes sequence odd, stores, then makes it even
+    // again; a reader retries when it saw an odd value or the value changed under it. All
+    // fields are atomics accessed relaxed, so a torn read is retried rather than undefined.
+    struct Page {
+        // Stored last when the page is created; readers wait for it.
+        std::atomic<uint32_t> magic;
+        uint32_t version;
+        int64_t pid;
+
+        std::atomic<uint32_t> sequence;
+        std::atomic<uint32_t> app_state;
+        std::atomic<uint32_t> game_index;
+        std::atomic<uint32_t> last_frame_us;
+        std::atomic<uint64_t> frames;
+        std::atomic<uint64_t> ticks;
+        std::atomic<uint64_t> draw_calls;
+        std::atomic<uint64_t> allocations;
+        std::atomic<uint64_t> audio_underruns;
+        std::atomic<uint32_t> audio_latency_us;
+        std::array<std::atomic<uint64_t>, HISTOGRAM_BUCKETS> frame_time_histogram;
+        // NUL-padded game name packed into words so it can be stored atomically.
+        std::array<std::atomic<uint64_t>, GAME_NAME_WORDS> game_name;
+    };
+
+    static_assert(std::atomic<uint64_t>::is_always_lock_free, "the metrics page needs lock-free 64-bit atomics");
+
+    [[nodiscard]] constexpr size_t bucketFor(const uint32_t frame_us) noexcept {
+        size_t bucket = 0;
+        while (bucket + 1 < HISTOGRAM_BUCKETS && frame_us >= BUCKET_BASE_US << bucket) {
+            ++bucket;
+        }
+        return bucket;
+    }
+
+    // Consistent copy of the guarded fields, as taken by a reader.
+    struct Snapshot {
+        uint32_t app_state{};
+        uint32_t game_index{};
+        uint32_t last_frame_us{};
+        uint64_t frames{};
+        uint64_t ticks{};
+        uint64_t draw_calls{};
+        uint64_t allocations{};
+        uint64_t audio_underruns{};
+        uint32_t audio_latency_us{};
+        std::array<uint64_t, HISTOGRAM_BUCKETS> frame_time_histogram{};
+        std::array<uint64_t, GAME_NAME_WORDS> game_name{};
+
+        [[nodiscard]] std::string_view gameName() const noexcept {
+            const auto *chars = reinterpret_cast<const char *>(game_name.data());
+            return {chars, strnlen(chars, sizeof(game_name))};
+        }
+    };
+
+    // Never blocks the writer: retries while a write is in progress and gives up after
+    // the given number of attempts.
+    [[nodiscard]] inline bool read(const Page &page, Snapshot &out, const int attempts = 1000) noexcept {
+        for (int attempt = 0; attempt < attempts; ++attempt) {
+            const uint32_t before = page.sequence.load(std::memory_order_acquire);
+            if (before & 1) continue;
+
+            out.app_state = page.app_state.load(std::memory_order_relaxed);
+            out.game_index = page.game_index.load(std::memory_order_relaxed);
+            out.last_frame_us = page.last_frame_us.load(std::memory_order_relaxed);
+            out.frames = page.frames.load(std::memory_order_relaxed);
+            out.ticks = page.ticks.load(std::memory_order_relaxed);
+            out.draw_calls = page.draw_calls.load(std::memory_order_relaxed);
+            out.allocations = page.allocations.load(std::memory_order_relaxed);
+            out.audio_underruns = page.audio_underruns.load(std::memory_order_relaxed);
+            out.audio_latency_us = page.audio_latency_us.load(std::memory_order_relaxed);
+            for (size_t i = 0; i < HISTOGRAM_BUCKETS; ++i) {
+                out.frame_time_histogram[i] = page.frame_time_histogram[i].load(std::memory_order_relaxed);
+            }
+            for (size_t i = 0; i < GAME_NAME_WORDS; ++i) {
+                out.game_name[i] = page.game_name[i].load(std::memory_order_relaxed);
+            }
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (page.sequence.load(std::memory_order_relaxed) == before) return true;
+        }
+        return false;
+    }
+
+    // One frame's worth of counters as the main loop sees them.
+    struct FrameSample {
+        uint32_t app_state;
+        uint32_t game_index;
+        uint32_t frame_us;
+        uint32_t ticks;
+        uint32_t draw_calls;
+        uint64_t allocations;
+        // Running totals from the mixer, stored as they are rather than accumulated.
+        uint64_t audio_underruns;
+        uint32_t audio_latency_us;
+    };
+
+    // Per-process name, so several instances on one host can be monitored side by side.
+    [[nodiscard]] inline std::string defaultPageName() {
+#ifdef HAS_METRICS_PAGE
+        return "/retro_games." + std::to_string(getpid());
+#else
+        return "/retro_games";
+#endif
+    }
+
+    // Owns the page under /dev/shm (or the platform's equivalent) for the life of the
+    // process and unlinks it on exit. publish() is a few relaxed stores and never waits
+    // on readers.
+    class Publisher {
+        std::string name_;
+        Page *page_{nullptr};
+        std::array<uint64_t, GAME_NAME_WORDS> game_name_{};
+
+        void begin() noexcept {
+            page_->sequence.store(page_->sequence.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+        }
+
+        void end() noexcept {
+            page_->sequence.store(page_->sequence.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        }
+
+        // Only this process writes, so counters advance with a plain load and store
+        // rather than a locked read-modify-write.
+        static void add(std::atomic<uint64_t> &counter, const uint64_t amount) noexcept {
+            counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+        }
+
+    public:
+        explicit Publisher(std::string name) : name_(std::move(name)) {
+#ifdef HAS_METRICS_PAGE
+            const int fd = shm_open(name_.c_str(), O_CREAT | O_RDWR | O_TRUNC, 0644);
+            if (fd < 0) {
+                throw std::runtime_error("Failed to create metrics page " + name_ + ": " + std::strerror(errno));
+            }
+            if (ftruncate(fd, sizeof(Page)) != 0) {
+                const int error = errno;
+                close(fd);
+                shm_unlink(name_.c_str());
+                throw std::runtime_error("Failed to size metrics page " + name_ + ": " + std::strerror(error));
+            }
+
+            void *memory = mmap(nullptr, sizeof(Page), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+            close(fd);
+            if (memory == MAP_FAILED) {
+                shm_unlink(name_.c_str());
+                throw std::runtime_error("Failed to map metrics page " + name_ + ": " + std::strerror(errno));
+            }
+
+            // The fresh mapping is zero-filled, which is a valid state for every atomic.
+            page_ = static_cast<Page *>(memory);
+            page_->pid = static_cast<int64_t>(getpid());
+            page_->version = VERSION;
+            page_->magic.store(MAGIC, std::memory_order_release);
+#else
+            throw std::runtime_error("Metrics pages are not supported on this platform");
+#endif
+        }
+
+        ~Publisher() {
+#ifdef HAS_METRICS_PAGE
+            munmap(page_, sizeof(Page));
+            shm_unlink(name_.c_str());
+#endif
+        }
+
+        Publisher(const Publisher &) = delete;
+
+        Publisher &operator=(const Publisher &) = delete;
+
+        // Name of the running game, or empty in the menu. Only stored when it changes.
+        void setGame(const std::string_view name) noexcept {
+            std::array<uint64_t, GAME_NAME_WORDS> words{};
+            std::memcpy(words.data(), name.data(), std::min(name.size(), sizeof(words) - 1));
+            if (words == game_name_) return;
+
+            game_name_ = words;
+            begin();
+            for (size_t i = 0; i < GAME_NAME_WORDS; ++i) {
+                page_->game_name[i].store(words[i], std::memory_order_relaxed);
+            }
+            end();
+        }
+
+        void publish(const FrameSample &sample) noexcept {
+            begin();
+            page_->app_state.store(sample.app_state, std::memory_order_relaxed);
+            page_->game_index.store(sample.game_index, std::memory_order_relaxed);
+            page_->last_frame_us.store(sample.frame_us, std::memory_order_relaxed);
+            add(page_->frames, 1);
+            add(page_->ticks, sample.ticks);
+            add(page_->draw_calls, sample.draw_calls);
+            add(page_->allocations, sample.allocations);
+            page_->audio_underruns.store(sample.audio_underruns, std::memory_order_relaxed);
+            page_->audio_latency_us.store(sample.audio_latency_us, std::memory_order_relaxed);
+            add(page_->frame_time_histogram[bucketFor(sample.frame_us)], 1);
+            end();
+        }
+
+        [[nodiscard]] const std::string &name() const noexcept { return name_; }
+    };
+}
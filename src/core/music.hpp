@@ -0,0 +1,450 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace core::audio {
+    // Streams a WAV file, or headerless 16-bit stereo 44.1 kHz PCM (.raw / .pcm), as
+    // interleaved stereo float at the device rate. The end of the data wraps straight
+    // back to its start, so a track loops without a gap. Only one chunk of the file is
+    // held in memory at a time.
+    class MusicDecoder {
+        enum class Encoding : uint8_t {
+            UnsignedInt,
+            SignedInt,
+            Float
+        };
+
+        static constexpr size_t CHUNK_BYTES = 16 * 1024;
+
+        std::ifstream file_;
+        Encoding encoding_{Encoding::SignedInt};
+        int channels_{2};
+        int bytes_per_sample_{2};
+        int source_rate_{44100};
+        std::streamoff data_start_{0};
+        std::streamoff data_size_{0};
+        std::streamoff data_read_{0};
+
+        std::vector<char> chunk_;
+        size_t chunk_offset_{0};
+
+        // Linear resampling between the last two source frames.
+        double step_{1.0};
+        double fraction_{0.0};
+        std::array<float, 2> previous_{}, next_{};
+
+        [[nodiscard]] static uint32_t le32(const char *bytes) noexcept {
+            return static_cast<uint32_t>(static_cast<unsigned char>(bytes[0])) |
+                   static_cast<uint32_t>(static_cast<unsigned char>(bytes[1])) << 8 |
+                   static_cast<uint32_t>(static_cast<unsigned char>(bytes[2])) << 16 |
+                   static_cast<uint32_t>(static_cast<unsigned char>(bytes[3])) << 24;
+        }
+
+        [[nodiscard]] static uint16_t le16(const char *bytes) noexcept {
+            return static_cast<uint16_t>(static_cast<unsigned char>(bytes[0]) |
+                                         static_cast<unsigned char>(bytes[1]) << 8);
+        }
+
+        bool parseWav() {
+            char header[12];
+            if (!file_.read(header, sizeof(header)) || std::memcmp(header, "RIFF", 4) != 0 ||
+                std::memcmp(header + 8, "WAVE", 4) != 0) {
+                return false;
+            }
+
+            bool have_format = false;
+            char chunk[8];
+            while (file_.read(chunk, sizeof(chunk))) {
+                const uint32_t size = le32(chunk + 4);
+                if (std::memcmp(chunk, "fmt ", 4) == 0) {
+                    char format[40]{};
+                    if (size < 16 || !file_.read(format, std::min<uint32_t>(size, sizeof(format)))) return false;
+
+                    uint16_t tag = le16(format);
+                    // WAVE_FORMAT_EXTENSIBLE keeps the real tag at the start of the subformat GUID.
+                    if (tag == 0xfffe && size >= 26) tag = le16(format + 24);
+                    channels_ = le16(format + 2);
+                    source_rate_ = static_cast<int>(le32(format + 4));
+                    bytes_per_sample_ = le16(format + 14) / 8;
+
+                    if (tag == 1) {
+                        encoding_ = bytes_per_sample_ == 1 ? Encoding::UnsignedInt : Encoding::SignedInt;
+                    } else if (tag == 3 && bytes_per_sample_ == 4) {
+                        encoding_ = Encoding::Float;
+                    } else {
+                        return false;
+                    }
+                    if (channels_ < 1 || source_rate_ <= 0 || bytes_per_sample_ < 1 || bytes_per_sample_ > 4) {
+                        return false;
+                    }
+                    have_format = true;
+                    file_.seekg(static_cast<std::streamoff>(size + (size & 1)) -
+                                static_cast<std::streamoff>(std::min<uint32_t>(size, sizeof(format))), std::ios::cur);
+                } else if (std::memcmp(chunk, "data", 4) == 0) {
+                    // Streamed or truncated files can claim more data than they hold.
+                    data_start_ = file_.tellg();
+                    file_.seekg(0, std::ios::end);
+                    data_size_ = std::min<std::streamoff>(size, file_.tellg() - data_start_);
+                    file_.seekg(data_start_);
+                    return have_format;
+                } else {
+                    // Chunks are word aligned.
+                    file_.seekg(static_cast<std::streamoff>(size + (size & 1)), std::ios::cur);
+                }
+            }
+            return false;
+        }
+
+        [[nodiscard]] float decodeSample(const char *bytes) const noexcept {
+            switch (encoding_) {
+                case Encoding::UnsignedInt:
+                    return (static_cast<float>(static_cast<unsigned char>(bytes[0])) - 128.0f) / 128.0f;
+                case Encoding::Float: {
+                    float value;
+                    std::memcpy(&value, bytes, sizeof(value));
+                    return value;
+                }
+                case Encoding::SignedInt:
+                default: {
+                    // Left-justify into 32 bits so every width scales the same way.
+                    uint32_t value = 0;
+                    for (int i = 0; i < bytes_per_sample_; ++i) {
+                        value |= static_cast<uint32_t>(static_cast<unsigned char>(bytes[i])) << (32 - 8 * (bytes_per_sample_ - i));
+                    }
+                    return static_cast<float>(static_cast<int32_t>(value)) / 2147483648.0f;
+                }
+            }
+        }
+
+        // Refills the chunk from the data, rewinding to its start at the end.
+        bool refill() {
+            const size_t frame_bytes = static_cast<size_t>(channels_ * bytes_per_sample_);
+            if (data_read_ + static_cast<std::streamoff>(frame_bytes) > data_size_) {
+                file_.clear();
+                file_.seekg(data_start_);
+                data_read_ = 0;
+            }
+
+            const std::streamoff left = data_size_ - data_read_;
+            const size_t bytes = std::min<size_t>(CHUNK_BYTES / frame_bytes * frame_bytes, static_cast<size_t>(left)) /
+                                 frame_bytes * frame_bytes;
+            chunk_.resize(bytes);
+            if (bytes == 0 || !file_.read(chunk_.data(), static_cast<std::streamsize>(bytes))) return false;
+
+            data_read_ += static_cast<std::streamoff>(bytes);
+            chunk_offset_ = 0;
+            return true;
+        }
+
+        bool nextSourceFrame(std::array<float, 2> &frame) {
+            if (chunk_offset_ >= chunk_.size() && !refill()) return false;
+
+            const char *bytes = chunk_.data() + chunk_offset_;
+            frame[0] = decodeSample(bytes);
+            frame[1] = channels_ > 1 ? decodeSample(bytes + bytes_per_sample_) : frame[0];
+            chunk_offset_ += static_cast<size_t>(channels_ * bytes_per_sample_);
+            return true;
+        }
+
+    public:
+        bool open(const std::string &path, const int device_rate) {
+            file_.open(path, std::ios::binary);
+            if (!file_) return false;
+
+            const bool raw = path.ends_with(".raw") || path.ends_with(".pcm");
+            if (raw) {
+                file_.seekg(0, std::ios::end);
+                data_size_ = file_.tellg();
+                file_.seekg(0);
+            } else if (!parseWav()) {
+                return false;
+            }
+
+            step_ = static_cast<double>(source_rate_) / static_cast<double>(device_rate);
+            chunk_.reserve(CHUNK_BYTES);
+            return nextSourceFrame(previous_) && nextSourceFrame(next_);
+        }
+
+        // Writes up to frames stereo frames; fewer only when the file cannot be read.
+        size_t read(float *out, const size_t frames) {
+            for (size_t i = 0; i < frames; ++i) {
+                while (fraction_ >= 1.0) {
+                    previous_ = next_;
+                    if (!nextSourceFrame(next_)) return i;
+                    fraction_ -= 1.0;
+                }
+                const auto t = static_cast<float>(fraction_);
+                out[2 * i] = previous_[0] + (next_[0] - previous_[0]) * t;
+                out[2 * i + 1] = previous_[1] + (next_[1] - previous_[1]) * t;
+                fraction_ += step_;
+            }
+            return frames;
+        }
+    };
+
+    namespace detail {
+        // Interleaved stereo frames passed from one writer thread to one reader thread.
+        class SampleRing {
+        public:
+            static constexpr size_t FRAMES = size_t{1} << 16;
+
+        private:
+            std::unique_ptr<float[]> samples_{std::make_unique<float[]>(FRAMES * 2)};
+            std::atomic<size_t> read_{0};
+            std::atomic<size_t> write_{0};
+
+        public:
+            // Writer only, and only while no reader is active.
+            void reset() noexcept {
+                read_.store(0, std::memory_order_relaxed);
+                write_.store(0, std::memory_order_release);
+            }
+
+            [[nodiscard]] size_t writable() const noexcept {
+                return FRAMES - (write_.load(std::memory_order_relaxed) - read_.load(std::memory_order_acquire));
+            }
+
+            // Writer only: hands out the contiguous free run, committed with commit().
+            [[nodiscard]] std::pair<float *, size_t> writeSpan() const noexcept {
+                const size_t write = write_.load(std::memory_order_relaxed);
+                const size_t offset = write & (FRAMES - 1);
+                return {samples_.get() + offset * 2, std::min(writable(), FRAMES - offset)};
+            }
+
+            void commit(const size_t frames) noexcept {
+                write_.store(write_.load(std::memory_order_relaxed) + frames, std::memory_order_release);
+            }
+
+            // Reader only.
+            size_t read(float *out, const size_t frames) noexcept {
+                const size_t read = read_.load(std::memory_order_relaxed);
+                const size_t count = std::min(frames, write_.load(std::memory_order_acquire) - read);
+                const size_t offset = read & (FRAMES - 1);
+                const size_t first = std::min(count, FRAMES - offset);
+                std::memcpy(out, samples_.get() + offset * 2, first * 2 * sizeof(float));
+                std::memcpy(out + first * 2, samples_.get(), (count - first) * 2 * sizeof(float));
+                read_.store(read + count, std::memory_order_release);
+                return count;
+            }
+        };
+    }
+
+    // Background music: a decoder thread keeps two ring-buffered slots topped up and the
+    // audio callback mixes them, fading the new track in while the old one fades out.
+    // Memory stays at the two rings plus a decoder chunk whatever the track length.
+    class MusicPlayer {
+        enum class SlotState : uint8_t {
+            // Owned by the decoder thread; the callback ignores it.
+            Idle,
+            // Read and faded by the callback.
+            Playing,
+            FadingOut
+        };
+
+        struct Slot {
+            detail::SampleRing ring;
+            std::atomic<SlotState> state{SlotState::Idle};
+            // Decoder thread only.
+            std::unique_ptr<MusicDecoder> decoder;
+            // Callback only.
+            float gain{0.0f};
+        };
+
+        static constexpr std::chrono::milliseconds POLL_INTERVAL{20};
+        static constexpr float CROSSFADE_SECONDS = 1.0f;
+        // Leaves headroom for the effects mixed on top.
+        static constexpr float VOLUME = 0.5f;
+        static constexpr size_t MIX_FRAMES = 256;
+
+        std::array<Slot, 2> slots_;
+        int device_rate_{48000};
+        float fade_step_{1.0f};
+        std::atomic<uint64_t> underrun_frames_{0};
+        std::array<float, MIX_FRAMES * 2> scratch_{};
+
+        std::thread thread_;
+        std::mutex mutex_;
+        std::condition_variable wake_;
+        // An empty path stops the music.
+        std::optional<std::string> request_;
+        bool new_request_{false};
+        bool running_{false};
+
+        static void fill(Slot &slot) {
+            while (slot.ring.writable() > 0) {
+                const auto [out, frames] = slot.ring.writeSpan();
+                const size_t written = slot.decoder->read(out, frames);
+                slot.ring.commit(written);
+                if (written < frames) return;
+            }
+        }
+
+        void fadeOutPlaying(const Slot *except) noexcept {
+            for (Slot &slot: slots_) {
+                if (&slot != except && slot.state.load(std::memory_order_relaxed) == SlotState::Playing) {
+                    slot.state.store(SlotState::FadingOut, std::memory_order_release);
+                }
+            }
+        }
+
+        // True once the request is handled; false leaves it queued until a slot frees up.
+        bool switchTo(const std::string &path) {
+            if (path.empty()) {
+                fadeOutPlaying(nullptr);
+                return true;
+            }
+
+            const auto free = std::ranges::find_if(slots_, [](const Slot &slot) {
+                return slot.state.load(std::memory_order_acquire) == SlotState::Idle;
+            });
+            if (free == slots_.end()) return false;
+
+            auto decoder = std::make_unique<MusicDecoder>();
+            if (!decoder->open(path, device_rate_)) {
+                std::cerr << "Cannot play music " << path << "\n";
+                return true;
+            }
+
+            // Primed before the callback sees it, so playback starts without a gap.
+            free->decoder = std::move(decoder);
+            free->ring.reset();
+            fill(*free);
+            fadeOutPlaying(&*free);
+            free->state.store(SlotState::Playing, std::memory_order_release);
+            return true;
+        }
+
+        void decode() {
+            std::unique_lock lock(mutex_);
+            while (running_) {
+                new_request_ = false;
+                if (request_) {
+                    const std::string path = *request_;
+                    lock.unlock();
+                    const bool handled = switchTo(path);
+                    lock.lock();
+                    if (handled && !new_request_) request_.reset();
+                }
+                lock.unlock();
+
+                for (Slot &slot: slots_) {
+                    if (!slot.decoder) continue;
+                    if (slot.state.load(std::memory_order_acquire) == SlotState::Idle) {
+                        slot.decoder.reset();
+                    } else {
+                        fill(slot);
+                    }
+                }
+
+                lock.lock();
+                wake_.wait_for(lock, POLL_INTERVAL, [this] { return !running_ || new_request_; });
+            }
+        }
+
+    public:
+        MusicPlayer() = default;
+
+        ~MusicPlayer() {
+            close();
+        }
+
+        MusicPlayer(const MusicPlayer &) = delete;
+
+        MusicPlayer &operator=(const MusicPlayer &) = delete;
+
+        void open(const int device_rate) {
+            device_rate_ = device_rate;
+            fade_step_ = 1.0f / (CROSSFADE_SECONDS * static_cast<float>(device_rate));
+            running_ = true;
+            thread_ = std::thread([this] { decode(); });
+        }
+
+        // Call after the device is closed, so the callback no longer reads the slots.
+        void close() {
+            {
+                std::lock_guard lock(mutex_);
+                if (!running_) return;
+                running_ = false;
+                request_.reset();
+            }
+            wake_.notify_one();
+            thread_.join();
+
+            for (Slot &slot: slots_) {
+                slot.decoder.reset();
+                slot.gain = 0.0f;
+                slot.state.store(SlotState::Idle, std::memory_order_relaxed);
+            }
+        }
+
+        // Crossfades to path, or fades out with an empty path. Only the latest request
+        // is kept when several arrive before the decoder gets to them.
+        void play(std::string path) {
+            {
+                std::lock_guard lock(mutex_);
+                if (!running_) return;
+                request_ = std::move(path);
+                new_request_ = true;
+            }
+            wake_.notify_one();
+        }
+
+        // Audio callback only: adds the music into interleaved output.
+        void mix(float *out, const size_t frames, const size_t channels) noexcept {
+            for (Slot &slot: slots_) {
+                const SlotState state = slot.state.load(std::memory_order_acquire);
+                if (state == SlotState::Idle) continue;
+
+                const float target = state == SlotState::Playing ? 1.0f : 0.0f;
+                for (size_t done = 0; done < frames;) {
+                    const size_t wanted = std::min(MIX_FRAMES, frames - done);
+                    const size_t got = slot.ring.read(scratch_.data(), wanted);
+                    if (got < wanted) {
+                        underrun_frames_.store(underrun_frames_.load(std::memory_order_relaxed) + (wanted - got),
+                                               std::memory_order_relaxed);
+                    }
+
+                    // The fade keeps moving through gaps, so a starved track still fades out.
+                    std::fill(scratch_.begin() + static_cast<std::ptrdiff_t>(got * 2), scratch_.end(), 0.0f);
+                    for (size_t i = 0; i < wanted; ++i) {
+                        slot.gain = slot.gain < target
+                                        ? std::min(target, slot.gain + fade_step_)
+                                        : std::max(target, slot.gain - fade_step_);
+                        const float gain = slot.gain * VOLUME;
+                        float *frame = out + (done + i) * channels;
+                        if (channels == 1) {
+                            frame[0] += 0.5f * (scratch_[2 * i] + scratch_[2 * i + 1]) * gain;
+                        } else {
+                            frame[0] += scratch_[2 * i] * gain;
+                            frame[1] += scratch_[2 * i + 1] * gain;
+                        }
+                    }
+                    done += wanted;
+                }
+
+                if (state == SlotState::FadingOut && slot.gain <= 0.0f) {
+                    slot.state.store(SlotState::Idle, std::memory_order_release);
+                }
+            }
+        }
+
+        // Output frames the decoder could not supply in time.
+        [[nodiscard]] uint64_t underrunFrames() const noexcept {
+            return underrun_frames_.load(std::memory_order_relaxed);
+        }
+    };
+}
@@ -0,0 +1,187 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <cmath>
+#include <span>
+#include <vector>
+#include <algorithm>
+#include "math.hpp"
+#include "collision.hpp"
+#include "random.hpp"
+#include "render_backend.hpp"
+
+namespace core {
+    // How an emitter sprays particles: count per burst, a speed range fanned around a
+    // direction, a lifetime range, and a constant vertical acceleration. Particles fade
+    // and shrink to nothing over their life.
+    struct ParticlePreset {
+        uint32_t count;
+        float speed_min, speed_max;
+        float direction, spread; // radians; spread is the full fan width
+        float life_min, life_max;
+        float size;
+        float gravity;
+        Uint8 r, g, b;
+    };
+
+    namespace particle_presets {
+        inline constexpr ParticlePreset EXPLOSION{24, 40.0f, 160.0f, 0.0f, 6.2831853f, 0.3f, 0.7f, 4.0f, -120.0f, 255, 140, 40};
+        inline constexpr ParticlePreset SPARKS{8, 80.0f, 220.0f, 1.5707963f, 1.2f, 0.1f, 0.3f, 2.0f, -400.0f, 255, 255, 180};
+        inline constexpr ParticlePreset PUFF{10, 30.0f, 90.0f, -1.5707963f, 2.0f, 0.2f, 0.45f, 4.0f, 0.0f, 235, 235, 235};
+        inline constexpr ParticlePreset TRAIL{1, 5.0f, 20.0f, 3.1415926f, 0.8f, 0.25f, 0.4f, 3.0f, 0.0f, 255, 220, 60};
+    }
+
+    namespace detail {
+        // Lanes are padded to a multiple of this so the kernels run without tails.
+        inline constexpr size_t PARTICLE_LANE_BLOCK = 8;
+
+        struct ParticleLanes {
+            float *x, *y, *vx, *vy, *ay, *life;
+        };
+
+        using ParticleKernel = void (*)(const ParticleLanes &, size_t, float);
+
+        inline void integrateScalar(const ParticleLanes &p, const size_t count, const float dt) noexcept {
+            for (size_t i = 0; i < count; ++i) {
+                p.vy[i] += p.ay[i] * dt;
+                p.x[i] += p.vx[i] * dt;
+                p.y[i] += p.vy[i] * dt;
+                p.life[i] -= dt;
+            }
+        }
+
+#ifdef CORE_COLLISION_X86
+        inline void integrateSSE2(const ParticleLanes &p, const size_t count, const float dt) noexcept {
+            const __m128 step = _mm_set1_ps(dt);
+            for (size_t i = 0; i < count; i += 4) {
+                const __m128 vy = _mm_add_ps(_mm_loadu_ps(p.vy + i), _mm_mul_ps(_mm_loadu_ps(p.ay + i), step));
+                _mm_storeu_ps(p.vy + i, vy);
+                _mm_storeu_ps(p.x + i, _mm_add_ps(_mm_loadu_ps(p.x + i), _mm_mul_ps(_mm_loadu_ps(p.vx + i), step)));
+                _mm_storeu_ps(p.y + i, _mm_add_ps(_mm_loadu_ps(p.y + i), _mm_mul_ps(vy, step)));
+                _mm_storeu_ps(p.life + i, _mm_sub_ps(_mm_loadu_ps(p.life + i), step));
+            }
+        }
+
+        __attribute__((target("avx2")))
+        inline void integrateAVX2(const ParticleLanes &p, const size_t count, const float dt) noexcept {
+            const __m256 step = _mm256_set1_ps(dt);
+            for (size_t i = 0; i < count; i += 8) {
+                const __m256 vy = _mm256_add_ps(_mm256_loadu_ps(p.vy + i), _mm256_mul_ps(_mm256_loadu_ps(p.ay + i), step));
+                _mm256_storeu_ps(p.vy + i, vy);
+                _mm256_storeu_ps(p.x + i, _mm256_add_ps(_mm256_loadu_ps(p.x + i), _mm256_mul_ps(_mm256_loadu_ps(p.vx + i), step)));
+                _mm256_storeu_ps(p.y + i, _mm256_add_ps(_mm256_loadu_ps(p.y + i), _mm256_mul_ps(vy, step)));
+                _mm256_storeu_ps(p.life + i, _mm256_sub_ps(_mm256_loadu_ps(p.life + i), step));
+            }
+        }
+#endif
+
+        [[nodiscard]] inline ParticleKernel particleKernelFor(const SimdLevel level) noexcept {
+            switch (level) {
+#ifdef CORE_COLLISION_X86
+                case SimdLevel::AVX2:
+                    return integrateAVX2;
+                case SimdLevel::SSE2:
+                    return integrateSSE2;
+#endif
+                default:
+                    return integrateScalar;
+            }
+        }
+    }
+
+    // Fixed-capacity particle pool stored as separate lanes. Live particles are packed at
+    // the front: integration runs over whole SIMD blocks, then dead particles are replaced
+    // by the last live one. Emitting into a full pool drops the excess.
+    class ParticleSystem {
+        size_t capacity_;
+        size_t size_{0};
+        std::vector<float> x_, y_, vx_, vy_, ay_, life_;
+        std::vector<float> inv_life_, extent_;
+        std::vector<uint32_t> color_;
+        Random random_{0x5eed};
+        detail::ParticleKernel kernel_;
+
+        void move(const size_t from, const size_t to) noexcept {
+            x_[to] = x_[from];
+            y_[to] = y_[from];
+            vx_[to] = vx_[from];
+            vy_[to] = vy_[from];
+            ay_[to] = ay_[from];
+            life_[to] = life_[from];
+            inv_life_[to] = inv_life_[from];
+            extent_[to] = extent_[from];
+            color_[to] = color_[from];
+        }
+
+    public:
+        explicit ParticleSystem(const size_t capacity, const SimdLevel level = detectSimdLevel())
+            : capacity_(capacity), kernel_(detail::particleKernelFor(level)) {
+            const size_t padded = (capacity + detail::PARTICLE_LANE_BLOCK - 1) / detail::PARTICLE_LANE_BLOCK *
+                                  detail::PARTICLE_LANE_BLOCK;
+            for (auto *lane: {&x_, &y_, &vx_, &vy_, &ay_, &life_, &inv_life_, &extent_}) {
+                lane->resize(padded);
+            }
+            color_.resize(padded);
+        }
+
+        void emit(const ParticlePreset &preset, const Vector2 at) {
+            const size_t count = std::min<size_t>(preset.count, capacity_ - size_);
+            const uint32_t color = static_cast<uint32_t>(preset.r) | static_cast<uint32_t>(preset.g) << 8 |
+                                   static_cast<uint32_t>(preset.b) << 16;
+
+            for (size_t n = 0; n < count; ++n, ++size_) {
+                const float angle = preset.direction + random_.uniform(-0.5f, 0.5f) * preset.spread;
+                const float speed = random_.uniform(preset.speed_min, preset.speed_max);
+                const float life = random_.uniform(preset.life_min, preset.life_max);
+
+                x_[size_] = at.x;
+                y_[size_] = at.y;
+                vx_[size_] = std::cos(angle) * speed;
+                vy_[size_] = std::sin(angle) * speed;
+                ay_[size_] = preset.gravity;
+                life_[size_] = life;
+                inv_life_[size_] = 1.0f / life;
+                extent_[size_] = preset.size;
+                color_[size_] = color;
+            }
+        }
+
+        // Restarts the spray pattern, so seeded games replay their effects exactly.
+        void reseed(const Random &random) noexcept {
+            random_ = random;
+        }
+
+        void update(const float dt) {
+            const detail::ParticleLanes lanes{x_.data(), y_.data(), vx_.data(), vy_.data(), ay_.data(), life_.data()};
+            const size_t blocks = (size_ + detail::PARTICLE_LANE_BLOCK - 1) / detail::PARTICLE_LANE_BLOCK;
+            kernel_(lanes, blocks * detail::PARTICLE_LANE_BLOCK, dt);
+
+            for (size_t i = 0; i < size_;) {
+                if (life_[i] > 0.0f) {
+                    ++i;
+                } else {
+                    move(--size_, i);
+                }
+            }
+        }
+
+        // Writes one quad per live particle; out must hold size() quads.
+        void fill(const std::span<Quad> out) const noexcept {
+            for (size_t i = 0; i < size_; ++i) {
+                const float remaining = life_[i] * inv_life_[i];
+                const uint32_t color = color_[i];
+                out[i] = {
+                    x_[i], y_[i], extent_[i] * remaining,
+                    static_cast<Uint8>(color), static_cast<Uint8>(color >> 8), static_cast<Uint8>(color >> 16),
+                    static_cast<Uint8>(remaining * 255.0f)
+                };
+            }
+        }
+
+        void clear() noexcept { size_ = 0; }
+
+        [[nodiscard]] size_t size() const noexcept { return size_; }
+        [[nodiscard]] size_t capacity() const noexcept { return capacity_; }
+        [[nodiscard]] bool empty() const noexcept { return size_ == 0; }
+    };
+}
@@ -0,0 +1,89 @@
+#pragma once
+#include <cstdint>
+#include <bit>
+#include <limits>
+
+namespace core {
+    // PCG32 (O'Neill): 16 bytes of state, one multiply per draw. Generators with the
+    // same seed but different streams are independent sequences, so parallel instances
+    // each take their own stream instead of sharing one generator. Also a standard
+    // UniformRandomBitGenerator, for the occasional <random> distribution.
+    class Random {
+        uint64_t state_{0};
+        uint64_t increment_{1};
+
+        static constexpr uint64_t MULTIPLIER = 6364136223846793005ULL;
+
+    public:
+        using result_type = uint32_t;
+
+        Random() noexcept : Random(0) {
+        }
+
+        explicit Random(const uint64_t seed, const uint64_t stream = 0) noexcept : increment_(stream << 1 | 1) {
+            next();
+            state_ += seed;
+            next();
+        }
+
+        uint32_t next() noexcept {
+            const uint64_t old = state_;
+            state_ = old * MULTIPLIER + increment_;
+            const auto xorshifted = static_cast<uint32_t>(((old >> 18) ^ old) >> 27);
+            return std::rotr(xorshifted, static_cast<int>(old >> 59));
+        }
+
+        uint64_t next64() noexcept {
+            const uint64_t high = next();
+            return high << 32 | next();
+        }
+
+        // Skips delta draws in O(log delta) steps.
+        void advance(uint64_t delta) noexcept {
+            uint64_t multiplier = MULTIPLIER, increment = increment_;
+            uint64_t total_multiplier = 1, total_increment = 0;
+            for (; delta > 0; delta >>= 1) {
+                if (delta & 1) {
+                    total_multiplier *= multiplier;
+                    total_increment = total_increment * multiplier + increment;
+                }
+                increment *= multiplier + 1;
+                multiplier *= multiplier;
+            }
+            state_ = total_multiplier * state_ + total_increment;
+        }
+
+        // A generator on a stream drawn from this one, for handing to a sub-system.
+        [[nodiscard]] Random split() noexcept {
+            const uint64_t seed = next64();
+            return Random{seed, next64()};
+        }
+
+        // Uniform in [0, bound) without modulo bias (Lemire); bound must be positive.
+        uint32_t below(const uint32_t bound) noexcept {
+            uint64_t product = static_cast<uint64_t>(next()) * bound;
+            if (auto low = static_cast<uint32_t>(product); low < bound) {
+                const uint32_t threshold = (0u - bound) % bound;
+                while (low < threshold) {
+                    product = static_cast<uint64_t>(next()) * bound;
+                    low = static_cast<uint32_t>(product);
+                }
+            }
+            return static_cast<uint32_t>(product >> 32);
+        }
+
+        // Uniform in [0, 1), from the top 24 bits.
+        float unit() noexcept {
+            return static_cast<float>(next() >> 8) * 0x1.0p-24f;
+        }
+
+        float uniform(const float lo, const float hi) noexcept {
+            return lo + (hi - lo) * unit();
+        }
+
+        uint32_t operator()() noexcept { return next(); }
+
+        static constexpr uint32_t min() noexcept { return 0; }
+        static constexpr uint32_t max() noexcept { return std::numeric_limits<uint32_t>::max(); }
+    };
+}
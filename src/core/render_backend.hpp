@@ -0,0 +1,103 @@
+#pragma once
+#include <SDL2/SDL.h>
+#include <string_view>
+#include <vector>
+#include <span>
+
+namespace core {
+    enum class RenderBackendKind {
+        OpenGL,
+        Software
+    };
+
+    // Borrowed RGBA32 pixels (R, G, B, A byte order), top row first.
+    struct ImageView {
+        const Uint8 *pixels{};
+        int width{}, height{};
+        int pitch{};
+    };
+
+    // Untextured square centered at (x, y), the unit of batched particle draws.
+    struct Quad {
+        float x, y;
+        float size;
+        Uint8 r, g, b, a;
+    };
+
+    // Single-channel coverage texture that text is drawn from, top row first. Borrowed
+    // for the backend's lifetime.
+    struct GlyphAtlas {
+        const Uint8 *coverage{};
+        int width{}, height{};
+    };
+
+    // Atlas rect (u, v, w, h in texels) drawn 1:1 with its bottom-left corner at (x, y);
+    // the coverage scales a.
+    struct GlyphQuad {
+        float x, y;
+        Uint16 u, v, w, h;
+        Uint8 r, g, b, a;
+    };
+
+    // GL state changes issued, and skipped as redundant, over one frame.
+    struct StateCallStats {
+        Uint32 issued{0};
+        Uint32 skipped{0};
+    };
+
+    // Coordinates follow the GL convention used throughout the games: origin at the
+    // bottom-left corner, y growing upwards, rects and circles given by their center.
+    class RenderBackend {
+    public:
+        virtual ~RenderBackend() = default;
+
+        virtual void clear(float r, float g, float b) = 0;
+
+        virtual void setColor(float r, float g, float b, float a) = 0;
+
+        // Offset added to every subsequent primitive until changed again.
+        virtual void setTranslation(float x, float y) = 0;
+
+        virtual void drawRect(float x, float y, float w, float h) = 0;
+
+        virtual void drawCircle(float x, float y, float radius, int segments) = 0;
+
+        // Draws every quad in one call. The default goes through drawRect one quad at a
+        // time; backends override it to hand the whole batch over at once.
+        virtual void drawQuads(const std::span<const Quad> quads) {
+            for (const Quad &quad: quads) {
+                setColor(quad.r / 255.0f, quad.g / 255.0f, quad.b / 255.0f, quad.a / 255.0f);
+                drawRect(quad.x, quad.y, quad.size, quad.size);
+            }
+        }
+
+        // Draws an image with its bottom-left corner at (x, y), modulated by alpha.
+        virtual void drawImage(const ImageView &image, float x, float y, float alpha, bool nearest) = 0;
+
+        // Called once, before any drawGlyphs, with the atlas the glyphs index into.
+        virtual void setGlyphAtlas(const GlyphAtlas &atlas) = 0;
+
+        // Draws every glyph in one call.
+        virtual void drawGlyphs(std::span<const GlyphQuad> glyphs) = 0;
+
+        // Reads the frame being built back as packed RGB24 rows, top row first.
+        virtual bool readPixels(std::vector<Uint8> &rgb) = 0;
+
+        virtual void present() = 0;
+
+        [[nodiscard]] virtual RenderBackendKind kind() const noexcept = 0;
+
+        // Counts for the last presented frame; backends without GL state report zeros.
+        [[nodiscard]] virtual StateCallStats stateCalls() const noexcept { return {}; }
+    };
+
+    [[nodiscard]] constexpr std::string_view toString(const RenderBackendKind kind) noexcept {
+        switch (kind) {
+            case RenderBackendKind::Software:
+                return "software";
+            case RenderBackendKind::OpenGL:
+            default:
+                return "gl";
+        }
+    }
+}
@@ -0,0 +1,243 @@
+#pragma once
+#include <SDL2/SDL.h>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <span>
+#include "render_backend.hpp"
+
+namespace core {
+    // Layers always draw in this order. Within a layer, shapes draw before images and
+    // images before baked text, and each group keeps its recording order, so overlapping
+    // shapes of one layer still stack as drawn.
+    enum class RenderLayer : uint8_t {
+        World,
+        Overlay
+    };
+
+    // A frame's draws recorded as plain data and replayed, sorted by layer and then
+    // material, into a backend. The list owns copies of everything it references, so it
+    // can be recorded on one thread and submitted on another. Storage is reused from frame
+    // to frame, so recording stops allocating once the buffers have grown to fit.
+    class RenderCommandList {
+        enum class Primitive : uint8_t {
+            Rect,
+            Circle,
+            Image,
+            Quads,
+            Glyphs
+        };
+
+        enum Material : uint8_t {
+            MATERIAL_SHAPE,
+            MATERIAL_IMAGE_LINEAR,
+            MATERIAL_IMAGE_NEAREST,
+            MATERIAL_GLYPHS
+        };
+
+        struct Command {
+            Primitive primitive;
+            RenderLayer layer;
+            Material material;
+            // Rect: center and size. Circle: center, radius in w. Image: bottom-left corner and size.
+            float x, y, w, h;
+            float r, g, b, a;
+            float translate_x, translate_y;
+            // Circle segment count, the image's offset into image_bytes_, or the index
+            // of the quad or glyph batch.
+            uint32_t data;
+        };
+
+        struct QuadBatch {
+            size_t offset;
+            size_t count;
+        };
+
+        static constexpr int INDEX_BITS = 48;
+        static constexpr uint64_t INDEX_MASK = (uint64_t{1} << INDEX_BITS) - 1;
+
+        std::vector<Command> commands_;
+        std::vector<uint64_t> order_;
+        std::vector<Uint8> image_bytes_;
+        std::vector<Quad> quads_;
+        std::vector<QuadBatch> quad_batches_;
+        std::vector<GlyphQuad> glyphs_;
+        std::vector<QuadBatch> glyph_batches_;
+        size_t submitted_{0};
+
+        bool has_clear_{false};
+        float clear_r_{0.0f}, clear_g_{0.0f}, clear_b_{0.0f};
+        float r_{1.0f}, g_{1.0f}, b_{1.0f}, a_{1.0f};
+        float translate_x_{0.0f}, translate_y_{0.0f};
+        RenderLayer layer_{RenderLayer::World};
+
+        void push(const Primitive primitive, const Material material,
+                  const float x, const float y, const float w, const float h, const uint32_t data) {
+            commands_.push_back({
+                primitive, layer_, material, x, y, w, h, r_, g_, b_, a_, translate_x_, translate_y_, data
+            });
+        }
+
+    public:
+        // Drops everything recorded so far; the frame starts over from this color.
+        void clear(const float r, const float g, const float b) {
+            commands_.clear();
+            image_bytes_.clear();
+            quads_.clear();
+            quad_batches_.clear();
+            glyphs_.clear();
+            glyph_batches_.clear();
+            has_clear_ = true;
+            clear_r_ = r;
+            clear_g_ = g;
+            clear_b_ = b;
+        }
+
+        void setColor(const float r, const float g, const float b, const float a) noexcept {
+            r_ = r;
+            g_ = g;
+            b_ = b;
+            a_ = a;
+        }
+
+        void setTranslation(const float x, const float y) noexcept {
+            translate_x_ = x;
+            translate_y_ = y;
+        }
+
+        void setLayer(const RenderLayer layer) noexcept {
+            layer_ = layer;
+        }
+
+        void drawRect(const float x, const float y, const float w, const float h) {
+            push(Primitive::Rect, MATERIAL_SHAPE, x, y, w, h, 0);
+        }
+
+        void drawCircle(const float x, const float y, const float radius, const int segments) {
+            push(Primitive::Circle, MATERIAL_SHAPE, x, y, radius, 0.0f, static_cast<uint32_t>(segments));
+        }
+
+        // Copies the pixels, tightly packed, into the list's image storage.
+        void drawImage(const ImageView &image, const float x, const float y, const float alpha, const bool nearest) {
+            const size_t row_bytes = static_cast<size_t>(image.width) * 4;
+            const size_t offset = image_bytes_.size();
+            image_bytes_.resize(offset + row_bytes * static_cast<size_t>(image.height));
+            for (int row = 0; row < image.height; ++row) {
+                std::memcpy(image_bytes_.data() + offset + static_cast<size_t>(row) * row_bytes,
+                            image.pixels + static_cast<size_t>(row) * static_cast<size_t>(image.pitch), row_bytes);
+            }
+
+            push(Primitive::Image, nearest ? MATERIAL_IMAGE_NEAREST : MATERIAL_IMAGE_LINEAR, x, y,
+                 static_cast<float>(image.width), static_cast<float>(image.height), static_cast<uint32_t>(offset));
+            commands_.back().a = alpha;
+        }
+
+        // Records one batched draw of count quads and returns them for the caller to fill.
+        // The span is only valid until the next drawQuads call.
+        std::span<Quad> drawQuads(const size_t count) {
+            const size_t offset = quads_.size();
+            quads_.resize(offset + count);
+            push(Primitive::Quads, MATERIAL_SHAPE, 0.0f, 0.0f, 0.0f, 0.0f, static_cast<uint32_t>(quad_batches_.size()));
+            quad_batches_.push_back({offset, count});
+            return std::span{quads_}.subspan(offset, count);
+        }
+
+        // Records count glyphs drawn from the backend's atlas, returned for the caller to
+        // fill. The span is only valid until the next drawGlyphs call.
+        std::span<GlyphQuad> drawGlyphs(const size_t count) {
+            const size_t offset = glyphs_.size();
+            glyphs_.resize(offset + count);
+            push(Primitive::Glyphs, MATERIAL_GLYPHS, 0.0f, 0.0f, 0.0f, 0.0f, static_cast<uint32_t>(glyph_batches_.size()));
+            glyph_batches_.push_back({offset, count});
+            return std::span{glyphs_}.subspan(offset, count);
+        }
+
+        // Replays the frame into backend in layer/material order and empties the list for
+        // the next frame. Layer and translation reset to their defaults; color carries over.
+        void submit(RenderBackend &backend) {
+            if (has_clear_) {
+                backend.clear(clear_r_, clear_g_, clear_b_);
+            }
+
+            order_.clear();
+            for (size_t i = 0; i < commands_.size(); ++i) {
+                const Command &command = commands_[i];
+                order_.push_back(static_cast<uint64_t>(command.layer) << 56 |
+                                 static_cast<uint64_t>(command.material) << INDEX_BITS | i);
+            }
+            std::ranges::sort(order_);
+
+            bool first = true;
+            float translate_x = 0.0f, translate_y = 0.0f;
+            for (size_t next = 0; next < order_.size(); ++next) {
+                const Command &command = commands_[order_[next] & INDEX_MASK];
+                if (first || command.translate_x != translate_x || command.translate_y != translate_y) {
+                    translate_x = command.translate_x;
+                    translate_y = command.translate_y;
+                    backend.setTranslation(translate_x, translate_y);
+                    first = false;
+                }
+
+                switch (command.primitive) {
+                    case Primitive::Rect:
+                        backend.setColor(command.r, command.g, command.b, command.a);
+                        backend.drawRect(command.x, command.y, command.w, command.h);
+                        break;
+                    case Primitive::Circle:
+                        backend.setColor(command.r, command.g, command.b, command.a);
+                        backend.drawCircle(command.x, command.y, command.w, static_cast<int>(command.data));
+                        break;
+                    case Primitive::Image: {
+                        const int width = static_cast<int>(command.w);
+                        const ImageView image{image_bytes_.data() + command.data, width, static_cast<int>(command.h), width * 4};
+                        backend.drawImage(image, command.x, command.y, command.a, command.material == MATERIAL_IMAGE_NEAREST);
+                        break;
+                    }
+                    case Primitive::Quads: {
+                        const QuadBatch &batch = quad_batches_[command.data];
+                        backend.drawQuads(std::span<const Quad>{quads_}.subspan(batch.offset, batch.count));
+                        break;
+                    }
+                    case Primitive::Glyphs: {
+                        // Strings recorded back to back sort next to each other with their
+                        // glyphs adjacent, so they go out as one draw.
+                        const QuadBatch &batch = glyph_batches_[command.data];
+                        size_t count = batch.count;
+                        while (next + 1 < order_.size()) {
+                            const Command &following = commands_[order_[next + 1] & INDEX_MASK];
+                            if (following.primitive != Primitive::Glyphs || following.translate_x != translate_x ||
+                                following.translate_y != translate_y ||
+                                glyph_batches_[following.data].offset != batch.offset + count) {
+                                break;
+                            }
+                            count += glyph_batches_[following.data].count;
+                            ++next;
+                        }
+                        backend.drawGlyphs(std::span<const GlyphQuad>{glyphs_}.subspan(batch.offset, count));
+                        break;
+                    }
+                }
+            }
+            if (!first && (translate_x != 0.0f || translate_y != 0.0f)) {
+                backend.setTranslation(0.0f, 0.0f);
+            }
+
+            submitted_ = commands_.size();
+            commands_.clear();
+            image_bytes_.clear();
+            quads_.clear();
+            quad_batches_.clear();
+            glyphs_.clear();
+            glyph_batches_.clear();
+            has_clear_ = false;
+            translate_x_ = translate_y_ = 0.0f;
+            layer_ = RenderLayer::World;
+        }
+
+        [[nodiscard]] size_t size() const noexcept { return commands_.size(); }
+        // Commands replayed by the last submit().
+        [[nodiscard]] size_t submitted() const noexcept { return submitted_; }
+        [[nodiscard]] bool empty() const noexcept { return commands_.empty(); }
+    };
+}
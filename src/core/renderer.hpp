@@ -1,106 +1,165 @@
 #pragma once
 #include <SDL2/SDL.h>
-#include <GL/gl.h>
-#include <GL/glu.h>
 #include <string_view>
-#include <cmath>
+#include <string>
+#include <vector>
 #include <memory>
+#include <cstdio>
+#include "render_backend.hpp"
+#include "render_commands.hpp"
+#include "gl_backend.hpp"
+#include "software_backend.hpp"
 #include "text.hpp"
+#include "frame_arena.hpp"
 
 
 namespace core {
+    // Draw calls are recorded into a command list and replayed into the backend, sorted
+    // by layer and material, when the frame is presented.
     class Renderer {
-        SDL_Window *window_{};
-        SDL_GLContext context_{};
+        std::unique_ptr<RenderBackend> backend_;
+        mutable RenderCommandList commands_;
+        mutable FrameArena frame_arena_;
         int width_{}, height_{};
         std::unique_ptr<FontManager> font_manager_;
         std::unique_ptr<TextRenderer> text_renderer_;
+        std::string dump_directory_;
+        Uint32 frame_index_{0};
+        std::vector<Uint8> capture_;
+
+        [[nodiscard]] static std::unique_ptr<RenderBackend> createBackend(const RenderBackendKind kind,
+                                                                          const std::string_view title,
+                                                                          const int width, const int height) {
+            switch (kind) {
+                case RenderBackendKind::Software:
+                    return std::make_unique<SoftwareRenderBackend>(title, width, height);
+                case RenderBackendKind::OpenGL:
+                default:
+                    return std::make_unique<GLRenderBackend>(title, width, height);
+            }
+        }
 
-    public:
-        Renderer(const std::string_view title, const int width, const int height)
-            : width_(width), height_(height) {
-            SDL_GL_SetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, 2);
-            SDL_GL_SetAttribute(SDL_GL_CONTEXT_MINOR_VERSION, 1);
-
-            window_ = SDL_CreateWindow(title.data(),
-                                       SDL_WINDOWPOS_CENTERED,
-                                       SDL_WINDOWPOS_CENTERED,
-                                       width, height,
-                                       SDL_WINDOW_OPENGL);
+        // Writes what the backend has drawn so far; the caller has already submitted it.
+        bool writeCapture(const std::string &path) {
+            if (!backend_->readPixels(capture_)) return false;
 
-            context_ = SDL_GL_CreateContext(window_);
+            std::FILE *file = std::fopen(path.c_str(), "wb");
+            if (!file) return false;
 
-            glViewport(0, 0, width, height);
-            glMatrixMode(GL_PROJECTION);
-            glLoadIdentity();
-            gluOrtho2D(0, width, 0, height);
-            glMatrixMode(GL_MODELVIEW);
-            glLoadIdentity();
+            std::fprintf(file, "P6\n%d %d\n255\n", width_, height_);
+            const bool ok = std::fwrite(capture_.data(), 1, capture_.size(), file) == capture_.size();
+            std::fclose(file);
+            return ok;
+        }
 
-            glEnable(GL_BLEND);
-            glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-            font_manager_ = std::make_unique<FontManager>();
-            text_renderer_ = std::make_unique<TextRenderer>(*font_manager_);
+    public:
+        Renderer(const std::string_view title, const int width, const int height,
+                 const RenderBackendKind backend = RenderBackendKind::OpenGL)
+            : backend_(createBackend(backend, title, width, height)), width_(width), height_(height) {
+#ifdef HAS_BAKED_FONT
+            backend_->setGlyphAtlas(BakedFont::atlas());
+            text_renderer_ = std::make_unique<TextRenderer>(nullptr, commands_);
+#endif
         }
 
-        ~Renderer() {
-            if (context_) SDL_GL_DeleteContext(context_);
-            if (window_) SDL_DestroyWindow(window_);
+        // Without the baked font, text draws are no-ops until fonts are attached, which lets
+        // font loading run on another thread while the window and GL context come up here.
+        void setFontManager(std::unique_ptr<FontManager> font_manager) {
+            font_manager_ = std::move(font_manager);
+            if (font_manager_ || !BAKED_FONT_AVAILABLE) {
+                text_renderer_ = font_manager_ ? std::make_unique<TextRenderer>(font_manager_.get(), commands_) : nullptr;
+            }
         }
 
+        ~Renderer() = default;
+
         Renderer(const Renderer &) = delete;
 
         Renderer &operator=(const Renderer &) = delete;
 
-        static void clear(const float r = 0.0f, const float g = 0.0f, const float b = 0.0f) noexcept {
-            glClearColor(r, g, b, 1.0f);
-            glClear(GL_COLOR_BUFFER_BIT);
+        void clear(const float r = 0.0f, const float g = 0.0f, const float b = 0.0f) const {
+            commands_.clear(r, g, b);
         }
 
-        void present() const noexcept {
-            SDL_GL_SwapWindow(window_);
+        void present() {
+            commands_.submit(*backend_);
+            if (!dump_directory_.empty()) {
+                char name[32];
+                std::snprintf(name, sizeof(name), "/frame_%06u.ppm", frame_index_);
+                writeCapture(dump_directory_ + name);
+            }
+            ++frame_index_;
+            backend_->present();
         }
 
-        static void setColor(const float r, const float g, const float b, const float a = 1.0f) noexcept {
-            glColor4f(r, g, b, a);
+        void setColor(const float r, const float g, const float b, const float a = 1.0f) const {
+            commands_.setColor(r, g, b, a);
         }
 
-        static void drawRect(const float x, const float y, const float w, const float h) noexcept {
-            glBegin(GL_QUADS);
-            glVertex2f(x - w / 2, y - h / 2);
-            glVertex2f(x + w / 2, y - h / 2);
-            glVertex2f(x + w / 2, y + h / 2);
-            glVertex2f(x - w / 2, y + h / 2);
-            glEnd();
+        void setTranslation(const float x, const float y) const {
+            commands_.setTranslation(x, y);
         }
 
-        static void drawCircle(const float x, const float y, const float radius, const int segments = 32) noexcept {
-            glBegin(GL_TRIANGLE_FAN);
-            glVertex2f(x, y);
+        // Layer for subsequent draws; resets to RenderLayer::World every frame.
+        void setLayer(const RenderLayer layer) const {
+            commands_.setLayer(layer);
+        }
 
-            for (int i = 0; i <= segments; ++i) {
-                const auto angle = static_cast<float>(2.0f * std::acos(-1.0) * i / segments);
-                glVertex2f(x + radius * std::cos(angle), y + radius * std::sin(angle));
-            }
-            glEnd();
+        void drawRect(const float x, const float y, const float w, const float h) const {
+            commands_.drawRect(x, y, w, h);
+        }
+
+        void drawCircle(const float x, const float y, const float radius, const int segments = 32) const {
+            commands_.drawCircle(x, y, radius, segments);
+        }
+
+        // One batched draw of count untextured quads, filled in by the caller before the
+        // next drawQuads call.
+        [[nodiscard]] std::span<Quad> drawQuads(const size_t count) const {
+            return commands_.drawQuads(count);
         }
 
         [[nodiscard]] constexpr int getWidth() const noexcept { return width_; }
         [[nodiscard]] constexpr int getHeight() const noexcept { return height_; }
 
-        void drawText(const std::string &text, const float x, const float y,
+        [[nodiscard]] RenderBackendKind getBackendKind() const noexcept { return backend_->kind(); }
+
+        [[nodiscard]] Uint32 getFrameIndex() const noexcept { return frame_index_; }
+
+        // Transient storage for the frame being built, reclaimed by the main loop once the
+        // frame is presented. Nothing allocated here may be kept past render().
+        [[nodiscard]] FrameArena &frameArena() const noexcept { return frame_arena_; }
+
+        // Primitives drawn in the last presented frame.
+        [[nodiscard]] size_t getDrawCallCount() const noexcept { return commands_.submitted(); }
+
+        // GL state changes issued and skipped as redundant during the last presented frame.
+        [[nodiscard]] StateCallStats getStateCallStats() const noexcept { return backend_->stateCalls(); }
+
+        // Writes every presented frame as <directory>/frame_NNNNNN.ppm for golden-image comparison.
+        void setFrameDumpDirectory(std::string directory) {
+            dump_directory_ = std::move(directory);
+        }
+
+        // Captures the frame being built (call before present) as a binary PPM.
+        bool dumpFrame(const std::string &path) {
+            commands_.submit(*backend_);
+            return writeCapture(path);
+        }
+
+        void drawText(const std::string_view text, const float x, const float y,
                       const float scale = 1.0f, const Color &color = Color{},
                       const TextAlign align = TextAlign::Left) const {
-            text_renderer_->drawText(text, x, y, scale, color, align);
+            if (text_renderer_) text_renderer_->drawText(text, x, y, scale, color, align);
         }
 
-        void drawTextCentered(const std::string &text, const float center_x, const float y,
+        void drawTextCentered(const std::string_view text, const float center_x, const float y,
                               const float scale = 1.0f, const Color &color = Color{}) const {
-            text_renderer_->drawTextCentered(text, center_x, y, scale, color);
+            if (text_renderer_) text_renderer_->drawTextCentered(text, center_x, y, scale, color);
         }
 
-        [[nodiscard]] float getTextWidth(const std::string &text, const float scale = 1.0f) const {
-            return text_renderer_->getTextWidth(text, scale);
+        [[nodiscard]] float getTextWidth(const std::string_view text, const float scale = 1.0f) const {
+            return text_renderer_ ? text_renderer_->getTextWidth(text, scale) : 0.0f;
         }
     };
 }
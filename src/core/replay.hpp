@@ -0,0 +1,338 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <cerrno>
+#include <algorithm>
+#include <array>
+#include <fstream>
+#include <iterator>
+#include <span>
+#include <string>
+#include <string_view>
+#include <stdexcept>
+#include <vector>
+#include "game.hpp"
+#include "input.hpp"
+#include "state_stream.hpp"
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define HAS_REPLAY_MMAP 1
+#endif
+
+namespace core::replay {
+    inline constexpr uint32_t MAGIC = 0x52475250; // "RGRP"
+    inline constexpr uint32_t VERSION = 1;
+    inline constexpr uint32_t DEFAULT_KEYFRAME_INTERVAL = 600;
+
+    inline constexpr size_t GAME_NAME_SIZE = 64;
+
+    struct Header {
+        uint32_t magic{MAGIC};
+        uint32_t version{VERSION};
+        uint64_t seed{0};
+        float tick_rate{0.0f};
+        uint32_t keyframe_interval{DEFAULT_KEYFRAME_INTERVAL};
+        // NUL-padded catalog name of the recorded game.
+        std::array<char, GAME_NAME_SIZE> game{};
+    };
+
+    static_assert(sizeof(Header) == 88, "the header is written as is and must have no padding");
+
+    // After the header the file is a run of records, each a tag byte and its payload:
+    //   'K' keyframe: u64 tick, u32 size, then size bytes of Game::saveState output. It
+    //       comes before the input of every tick that is a multiple of the interval.
+    //   'I' one tick's input: f32 horizontal, then a u8 of INPUT_* bits.
+    //   'R' the game was reset after the tick before it (autoplay rounds).
+    // Seeking loads the nearest keyframe and steps the ticks after it, so it never
+    // simulates more than one interval.
+    enum class Record : uint8_t {
+        Keyframe = 'K',
+        Input = 'I',
+        Reset = 'R'
+    };
+
+    // Games see both this tick's controls and the last tick's, for presses.
+    inline constexpr uint8_t INPUT_SHOOT = 1 << 0;
+    inline constexpr uint8_t INPUT_UP = 1 << 1;
+    inline constexpr uint8_t INPUT_DOWN = 1 << 2;
+    inline constexpr uint8_t INPUT_PREVIOUS_SHIFT = 3;
+
+    inline constexpr size_t INPUT_RECORD_SIZE = 1 + sizeof(float) + 1;
+    inline constexpr size_t KEYFRAME_RECORD_HEADER_SIZE = 1 + sizeof(uint64_t) + sizeof(uint32_t);
+
+    [[nodiscard]] constexpr uint8_t packButtons(const InputState &state) noexcept {
+        return static_cast<uint8_t>((state.shoot ? INPUT_SHOOT : 0) | (state.up ? INPUT_UP : 0) |
+                                    (state.down ? INPUT_DOWN : 0));
+    }
+
+    constexpr void unpackButtons(const uint8_t bits, InputState &state) noexcept {
+        state.shoot = bits & INPUT_SHOOT;
+        state.up = bits & INPUT_UP;
+        state.down = bits & INPUT_DOWN;
+    }
+
+    // Appends a game's ticks to a replay file. The game must be able to save its state.
+    class Recorder {
+        std::ofstream file_;
+        std::vector<uint8_t> scratch_;
+        uint32_t keyframe_interval_;
+        uint64_t ticks_{0};
+
+        template<typename T>
+        void put(const T &value) {
+            file_.write(reinterpret_cast<const char *>(&value), sizeof(T));
+        }
+
+    public:
+        Recorder(const std::string &path, const std::string_view game, const uint64_t seed, const float tick_rate,
+                 const uint32_t keyframe_interval = DEFAULT_KEYFRAME_INTERVAL)
+            : file_(path, std::ios::binary | std::ios::trunc), keyframe_interval_(keyframe_interval) {
+            if (!file_) {
+                throw std::runtime_error("Failed to create replay " + path + ": " + std::strerror(errno));
+            }
+
+            Header header;
+            header.seed = seed;
+            header.tick_rate = tick_rate;
+            header.keyframe_interval = keyframe_interval;
+            game.copy(header.game.data(), std::min(game.size(), GAME_NAME_SIZE - 1));
+            put(header);
+        }
+
+        // Call just before game.update, with the input it is about to read.
+        void tick(const games::Game &game, const InputManager &input) {
+            if (ticks_ % keyframe_interval_ == 0) {
+                scratch_.clear();
+                StateWriter writer{scratch_};
+                (void) game.saveState(writer);
+
+                put(Record::Keyframe);
+                put(ticks_);
+                put(static_cast<uint32_t>(scratch_.size()));
+                file_.write(reinterpret_cast<const char *>(scratch_.data()), static_cast<std::streamsize>(scratch_.size()));
+            }
+
+            put(Record::Input);
+            put(input.state().horizontal);
+            put(static_cast<uint8_t>(packButtons(input.state()) |
+                                     packButtons(input.previousState()) << INPUT_PREVIOUS_SHIFT));
+            ++ticks_;
+        }
+
+        // Call after a reset that happened outside game.update.
+        void reset() {
+            put(Record::Reset);
+        }
+
+        void flush() {
+            file_.flush();
+        }
+
+        [[nodiscard]] uint64_t ticks() const noexcept { return ticks_; }
+    };
+
+    // A replay file held in memory: mapped where the platform allows, else read in whole.
+    // Opening scans the records once for the keyframe index. A file cut short, say by a
+    // crash mid-recording, plays up to its last whole tick.
+    class Reader {
+    public:
+        struct Keyframe {
+            uint64_t tick;
+            size_t offset;
+        };
+
+    private:
+        const uint8_t *data_{nullptr};
+        size_t size_{0};
+        void *mapping_{nullptr};
+        std::vector<uint8_t> contents_;
+        Header header_{};
+        std::vector<Keyframe> keyframes_;
+        uint64_t ticks_{0};
+
+        void load(const std::string &path) {
+#ifdef HAS_REPLAY_MMAP
+            const int fd = ::open(path.c_str(), O_RDONLY);
+            if (fd < 0) {
+                throw std::runtime_error("Failed to open replay " + path + ": " + std::strerror(errno));
+            }
+            struct stat info{};
+            if (::fstat(fd, &info) == 0 && info.st_size > 0) {
+                void *mapping = ::mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+                if (mapping != MAP_FAILED) {
+                    mapping_ = mapping;
+                    data_ = static_cast<const uint8_t *>(mapping);
+                    size_ = static_cast<size_t>(info.st_size);
+                }
+            }
+            ::close(fd);
+            if (mapping_) return;
+#endif
+            std::ifstream file(path, std::ios::binary);
+            if (!file) {
+                throw std::runtime_error("Failed to open replay " + path + ": " + std::strerror(errno));
+            }
+            contents_.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+            data_ = contents_.data();
+            size_ = contents_.size();
+        }
+
+        void index() {
+            size_t offset = sizeof(Header);
+            while (offset < size_) {
+                const auto record = static_cast<Record>(data_[offset]);
+                if (record == Record::Input) {
+                    if (size_ - offset < INPUT_RECORD_SIZE) break;
+                    offset += INPUT_RECORD_SIZE;
+                    ++ticks_;
+                } else if (record == Record::Reset) {
+                    ++offset;
+                } else if (record == Record::Keyframe) {
+                    if (size_ - offset < KEYFRAME_RECORD_HEADER_SIZE) break;
+                    uint64_t tick = 0;
+                    uint32_t bytes = 0;
+                    std::memcpy(&tick, data_ + offset + 1, sizeof(tick));
+                    std::memcpy(&bytes, data_ + offset + 1 + sizeof(tick), sizeof(bytes));
+                    if (tick != ticks_ || size_ - offset - KEYFRAME_RECORD_HEADER_SIZE < bytes) break;
+                    keyframes_.push_back({tick, offset});
+                    offset += KEYFRAME_RECORD_HEADER_SIZE + bytes;
+                } else {
+                    break;
+                }
+            }
+
+            // A keyframe with no input after it leads nowhere.
+            while (!keyframes_.empty() && keyframes_.back().tick >= ticks_) {
+                keyframes_.pop_back();
+            }
+            if (keyframes_.empty() || keyframes_.front().tick != 0) {
+                throw std::runtime_error("Replay has no playable ticks");
+            }
+        }
+
+    public:
+        explicit Reader(const std::string &path) {
+            load(path);
+            if (size_ < sizeof(Header)) {
+                throw std::runtime_error("Not a replay: " + path);
+            }
+            std::memcpy(&header_, data_, sizeof(Header));
+            if (header_.magic != MAGIC || header_.version != VERSION) {
+                throw std::runtime_error("Not a replay, or from another version: " + path);
+            }
+            if (header_.tick_rate <= 0.0f || header_.keyframe_interval == 0) {
+                throw std::runtime_error("Corrupt replay header: " + path);
+            }
+            header_.game.back() = '\0';
+            index();
+        }
+
+        ~Reader() {
+#ifdef HAS_REPLAY_MMAP
+            if (mapping_) ::munmap(mapping_, size_);
+#endif
+        }
+
+        Reader(const Reader &) = delete;
+
+        Reader &operator=(const Reader &) = delete;
+
+        [[nodiscard]] std::span<const uint8_t> bytes() const noexcept { return {data_, size_}; }
+        [[nodiscard]] const Header &header() const noexcept { return header_; }
+        [[nodiscard]] std::string_view gameName() const noexcept { return header_.game.data(); }
+        [[nodiscard]] uint64_t ticks() const noexcept { return ticks_; }
+        [[nodiscard]] const std::vector<Keyframe> &keyframes() const noexcept { return keyframes_; }
+
+        // The last keyframe at or before tick.
+        [[nodiscard]] const Keyframe &keyframeFor(const uint64_t tick) const noexcept {
+            const auto after = std::upper_bound(keyframes_.begin(), keyframes_.end(), tick,
+                                                [](const uint64_t t, const Keyframe &keyframe) { return t < keyframe.tick; });
+            return *std::prev(after);
+        }
+    };
+
+    // Steps a game through a replay. Input goes through InputManager::replay, so the
+    // game reads the recorded controls while Escape and pause stay on the devices.
+    class Player {
+        const Reader &reader_;
+        games::Game &game_;
+        float dt_;
+        size_t offset_{0};
+        uint64_t tick_{0};
+        InputState previous_{};
+        InputState current_{};
+
+        void loadKeyframe(const Reader::Keyframe &keyframe) {
+            const std::span<const uint8_t> bytes = reader_.bytes();
+            uint32_t size = 0;
+            std::memcpy(&size, bytes.data() + keyframe.offset + 1 + sizeof(uint64_t), sizeof(size));
+            StateReader state{bytes.subspan(keyframe.offset + KEYFRAME_RECORD_HEADER_SIZE, size)};
+            if (!game_.loadState(state)) {
+                throw std::runtime_error("Replay keyframe at tick " + std::to_string(keyframe.tick) +
+                                         " does not fit " + std::string(game_.getName()));
+            }
+            offset_ = keyframe.offset;
+            tick_ = keyframe.tick;
+        }
+
+    public:
+        // Loads the first keyframe into game, which must be the game the replay recorded.
+        Player(const Reader &reader, games::Game &game)
+            : reader_(reader), game_(game), dt_(1.0f / reader.header().tick_rate) {
+            loadKeyframe(reader_.keyframes().front());
+        }
+
+        // Runs the next recorded tick; false at the end of the replay.
+        bool step(InputManager &input) {
+            if (tick_ >= reader_.ticks()) return false;
+
+            const std::span<const uint8_t> bytes = reader_.bytes();
+            if (static_cast<Record>(bytes[offset_]) == Record::Keyframe) {
+                uint32_t size = 0;
+                std::memcpy(&size, bytes.data() + offset_ + 1 + sizeof(uint64_t), sizeof(size));
+                offset_ += KEYFRAME_RECORD_HEADER_SIZE + size;
+            }
+
+            // The index only counted ticks whose input record is whole.
+            uint8_t buttons = 0;
+            std::memcpy(&current_.horizontal, bytes.data() + offset_ + 1, sizeof(float));
+            std::memcpy(&buttons, bytes.data() + offset_ + 1 + sizeof(float), sizeof(buttons));
+            unpackButtons(buttons, current_);
+            unpackButtons(buttons >> INPUT_PREVIOUS_SHIFT, previous_);
+            offset_ += INPUT_RECORD_SIZE;
+
+            input.replay(previous_, current_);
+            game_.update(dt_, input);
+            ++tick_;
+
+            if (offset_ < bytes.size() && static_cast<Record>(bytes[offset_]) == Record::Reset) {
+                game_.reset();
+                ++offset_;
+            }
+            return true;
+        }
+
+        // Moves to tick, from the nearest keyframe unless stepping on from here is shorter.
+        // Returns the number of ticks simulated.
+        uint64_t seek(uint64_t tick, InputManager &input) {
+            tick = std::min(tick, reader_.ticks());
+            if (const Reader::Keyframe &keyframe = reader_.keyframeFor(tick); tick < tick_ || keyframe.tick > tick_) {
+                loadKeyframe(keyframe);
+            }
+
+            uint64_t stepped = 0;
+            while (tick_ < tick && step(input)) {
+                ++stepped;
+            }
+            return stepped;
+        }
+
+        [[nodiscard]] uint64_t tick() const noexcept { return tick_; }
+        [[nodiscard]] uint64_t ticks() const noexcept { return reader_.ticks(); }
+        [[nodiscard]] float tickRate() const noexcept { return reader_.header().tick_rate; }
+    };
+}
@@ -0,0 +1,252 @@
+#pragma once
+#include <SDL2/SDL.h>
+#include <string_view>
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define CORE_SOFTWARE_RASTER_SSE2 1
+#endif
+#include "render_backend.hpp"
+
+namespace core {
+    // CPU rasterizer into an ARGB8888 framebuffer. Presents through a plain SDL window
+    // surface when a video driver is available (SDL_VIDEODRIVER=dummy works on machines
+    // without a GPU) and otherwise renders headless.
+    class SoftwareRenderBackend final : public RenderBackend {
+        SDL_Window *window_{};
+        int width_{}, height_{};
+        std::vector<Uint32> framebuffer_;
+        Uint32 color_{0xFFFFFFFFu};
+        Uint32 alpha_{255};
+        float translate_x_{0.0f}, translate_y_{0.0f};
+        GlyphAtlas atlas_{};
+
+        [[nodiscard]] static Uint32 toChannel(const float value) noexcept {
+            return static_cast<Uint32>(std::clamp(value, 0.0f, 1.0f) * 255.0f + 0.5f);
+        }
+
+        [[nodiscard]] static int firstPixel(const float edge) noexcept {
+            return static_cast<int>(std::ceil(edge - 0.5f));
+        }
+
+        [[nodiscard]] Uint32 *row(const int gl_y) noexcept {
+            return framebuffer_.data() + static_cast<size_t>(height_ - 1 - gl_y) * static_cast<size_t>(width_);
+        }
+
+        static void fillSpan(Uint32 *dst, int count, const Uint32 color) noexcept {
+#ifdef CORE_SOFTWARE_RASTER_SSE2
+            const __m128i value = _mm_set1_epi32(static_cast<int>(color));
+            for (; count >= 4; count -= 4, dst += 4) {
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), value);
+            }
+#endif
+            for (; count > 0; --count) {
+                *dst++ = color;
+            }
+        }
+
+        // dst = (src * a + dst * (255 - a)) / 255 per channel, result kept opaque.
+        static void blendSpan(Uint32 *dst, int count, const Uint32 color, const Uint32 alpha) noexcept {
+            const Uint32 inv_alpha = 255 - alpha;
+            const Uint32 src_r = ((color >> 16) & 0xFF) * alpha + 128;
+            const Uint32 src_g = ((color >> 8) & 0xFF) * alpha + 128;
+            const Uint32 src_b = (color & 0xFF) * alpha + 128;
+#ifdef CORE_SOFTWARE_RASTER_SSE2
+            const __m128i zero = _mm_setzero_si128();
+            const __m128i src = _mm_setr_epi16(static_cast<short>(src_b), static_cast<short>(src_g),
+                                               static_cast<short>(src_r), 0,
+                                               static_cast<short>(src_b), static_cast<short>(src_g),
+                                               static_cast<short>(src_r), 0);
+            const __m128i inv = _mm_set1_epi16(static_cast<short>(inv_alpha));
+            const __m128i opaque = _mm_set1_epi32(static_cast<int>(0xFF000000u));
+
+            for (; count >= 4; count -= 4, dst += 4) {
+                const __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i *>(dst));
+
+                __m128i lo = _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(pixels, zero), inv), src);
+                __m128i hi = _mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(pixels, zero), inv), src);
+                lo = _mm_srli_epi16(_mm_add_epi16(lo, _mm_srli_epi16(lo, 8)), 8);
+                hi = _mm_srli_epi16(_mm_add_epi16(hi, _mm_srli_epi16(hi, 8)), 8);
+
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), _mm_or_si128(_mm_packus_epi16(lo, hi), opaque));
+            }
+#endif
+            for (; count > 0; --count, ++dst) {
+                const Uint32 d = *dst;
+                Uint32 r = ((d >> 16) & 0xFF) * inv_alpha + src_r;
+                Uint32 g = ((d >> 8) & 0xFF) * inv_alpha + src_g;
+                Uint32 b = (d & 0xFF) * inv_alpha + src_b;
+                r = (r + (r >> 8)) >> 8;
+                g = (g + (g >> 8)) >> 8;
+                b = (b + (b >> 8)) >> 8;
+                *dst = 0xFF000000u | (r << 16) | (g << 8) | b;
+            }
+        }
+
+        void span(const int gl_y, int x0, int x1) noexcept {
+            if (gl_y < 0 || gl_y >= height_) return;
+            x0 = std::max(x0, 0);
+            x1 = std::min(x1, width_);
+            if (x0 >= x1) return;
+
+            Uint32 *dst = row(gl_y) + x0;
+            if (alpha_ == 255) {
+                fillSpan(dst, x1 - x0, color_);
+            } else if (alpha_ != 0) {
+                blendSpan(dst, x1 - x0, color_, alpha_);
+            }
+        }
+
+    public:
+        SoftwareRenderBackend(const std::string_view title, const int width, const int height)
+            : width_(width), height_(height),
+              framebuffer_(static_cast<size_t>(width) * static_cast<size_t>(height), 0xFF000000u) {
+            window_ = SDL_CreateWindow(title.data(),
+                                       SDL_WINDOWPOS_CENTERED,
+                                       SDL_WINDOWPOS_CENTERED,
+                                       width, height, 0);
+        }
+
+        ~SoftwareRenderBackend() override {
+            if (window_) SDL_DestroyWindow(window_);
+        }
+
+        SoftwareRenderBackend(const SoftwareRenderBackend &) = delete;
+
+        SoftwareRenderBackend &operator=(const SoftwareRenderBackend &) = delete;
+
+        void clear(const float r, const float g, const float b) override {
+            const Uint32 value = 0xFF000000u | toChannel(r) << 16 | toChannel(g) << 8 | toChannel(b);
+            fillSpan(framebuffer_.data(), static_cast<int>(framebuffer_.size()), value);
+        }
+
+        void setColor(const float r, const float g, const float b, const float a) override {
+            color_ = 0xFF000000u | toChannel(r) << 16 | toChannel(g) << 8 | toChannel(b);
+            alpha_ = toChannel(a);
+        }
+
+        void setTranslation(const float x, const float y) override {
+            translate_x_ = x;
+            translate_y_ = y;
+        }
+
+        void drawRect(float x, float y, const float w, const float h) override {
+            x += translate_x_;
+            y += translate_y_;
+            const int x0 = firstPixel(x - w / 2);
+            const int x1 = firstPixel(x + w / 2);
+            const int y0 = std::max(firstPixel(y - h / 2), 0);
+            const int y1 = std::min(firstPixel(y + h / 2), height_);
+
+            for (int gl_y = y0; gl_y < y1; ++gl_y) {
+                span(gl_y, x0, x1);
+            }
+        }
+
+        // Rasterizes the exact disc; the segment count only matters for the GL fan.
+        void drawCircle(float x, float y, const float radius, [[maybe_unused]] const int segments) override {
+            x += translate_x_;
+            y += translate_y_;
+            const float radius_sq = radius * radius;
+            const int y0 = std::max(firstPixel(y - radius), 0);
+            const int y1 = std::min(firstPixel(y + radius), height_);
+
+            for (int gl_y = y0; gl_y < y1; ++gl_y) {
+                const float dy = static_cast<float>(gl_y) + 0.5f - y;
+                const float remaining = radius_sq - dy * dy;
+                if (remaining < 0.0f) continue;
+
+                const float half = std::sqrt(remaining);
+                span(gl_y, firstPixel(x - half), firstPixel(x + half));
+            }
+        }
+
+        void drawImage(const ImageView &image, const float x, const float y,
+                       const float alpha, [[maybe_unused]] const bool nearest) override {
+            const int left = static_cast<int>(std::lround(x + translate_x_));
+            const int top = static_cast<int>(std::lround(y + translate_y_)) + image.height - 1;
+            const Uint32 modulate = toChannel(alpha);
+
+            for (int src_y = 0; src_y < image.height; ++src_y) {
+                const int gl_y = top - src_y;
+                if (gl_y < 0 || gl_y >= height_) continue;
+
+                const Uint8 *src = image.pixels + static_cast<size_t>(src_y) * static_cast<size_t>(image.pitch);
+                Uint32 *dst = row(gl_y);
+
+                const int first = std::max(0, -left);
+                const int last = std::min(image.width, width_ - left);
+                for (int src_x = first; src_x < last; ++src_x) {
+                    const Uint8 *px = src + src_x * 4;
+                    const Uint32 a = (px[3] * modulate + 127) / 255;
+                    if (a == 0) continue;
+
+                    const Uint32 color = static_cast<Uint32>(px[0]) << 16 | static_cast<Uint32>(px[1]) << 8 | px[2];
+                    blendSpan(dst + left + src_x, 1, color, a);
+                }
+            }
+        }
+
+        void setGlyphAtlas(const GlyphAtlas &atlas) override {
+            atlas_ = atlas;
+        }
+
+        void drawGlyphs(const std::span<const GlyphQuad> glyphs) override {
+            for (const GlyphQuad &glyph: glyphs) {
+                const int left = static_cast<int>(std::lround(glyph.x + translate_x_));
+                const int top = static_cast<int>(std::lround(glyph.y + translate_y_)) + glyph.h - 1;
+                const Uint32 color = static_cast<Uint32>(glyph.r) << 16 | static_cast<Uint32>(glyph.g) << 8 | glyph.b;
+                const int first = std::max(0, -left);
+                const int last = std::min(static_cast<int>(glyph.w), width_ - left);
+
+                for (int src_y = 0; src_y < glyph.h; ++src_y) {
+                    const int gl_y = top - src_y;
+                    if (gl_y < 0 || gl_y >= height_) continue;
+
+                    const Uint8 *coverage = atlas_.coverage +
+                                            static_cast<size_t>(glyph.v + src_y) * static_cast<size_t>(atlas_.width) + glyph.u;
+                    Uint32 *dst = row(gl_y);
+                    for (int src_x = first; src_x < last; ++src_x) {
+                        const Uint32 a = (coverage[src_x] * glyph.a + 127) / 255;
+                        if (a == 0) continue;
+
+                        blendSpan(dst + left + src_x, 1, color, a);
+                    }
+                }
+            }
+        }
+
+        bool readPixels(std::vector<Uint8> &rgb) override {
+            rgb.resize(framebuffer_.size() * 3);
+            Uint8 *out = rgb.data();
+            for (const Uint32 pixel: framebuffer_) {
+                *out++ = static_cast<Uint8>(pixel >> 16);
+                *out++ = static_cast<Uint8>(pixel >> 8);
+                *out++ = static_cast<Uint8>(pixel);
+            }
+            return true;
+        }
+
+        void present() override {
+            if (!window_) return;
+
+            SDL_Surface *surface = SDL_GetWindowSurface(window_);
+            if (!surface) return;
+
+            SDL_ConvertPixels(width_, height_, SDL_PIXELFORMAT_ARGB8888,
+                              framebuffer_.data(), width_ * static_cast<int>(sizeof(Uint32)),
+                              surface->format->format, surface->pixels, surface->pitch);
+            SDL_UpdateWindowSurface(window_);
+        }
+
+        [[nodiscard]] RenderBackendKind kind() const noexcept override {
+            return RenderBackendKind::Software;
+        }
+
+        [[nodiscard]] const Uint32 *pixels() const noexcept {
+            return framebuffer_.data();
+        }
+    };
+}
@@ -0,0 +1,52 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <type_traits>
+
+namespace core {
+    // Bounded wait-free queue for exactly one producer thread and one consumer thread.
+    // Each side keeps a cached copy of the other's index and only reloads it when the
+    // queue looks full (or empty), so the shared cache lines are touched rarely.
+    template<typename T, size_t Capacity>
+    class SpscQueue {
+        static_assert((Capacity & (Capacity - 1)) == 0, "SpscQueue capacity must be a power of two");
+        static_assert(std::is_trivially_copyable_v<T>, "SpscQueue elements are copied in and out");
+
+        static constexpr size_t CACHE_LINE = 64;
+        static constexpr size_t MASK = Capacity - 1;
+
+        alignas(CACHE_LINE) std::atomic<size_t> head_{0};
+        size_t cached_tail_{0};
+        alignas(CACHE_LINE) std::atomic<size_t> tail_{0};
+        size_t cached_head_{0};
+        alignas(CACHE_LINE) std::array<T, Capacity> slots_{};
+
+    public:
+        // Producer only. Returns false, leaving the queue untouched, when it is full.
+        bool push(const T &value) noexcept {
+            const size_t tail = tail_.load(std::memory_order_relaxed);
+            if (tail - cached_head_ == Capacity) {
+                cached_head_ = head_.load(std::memory_order_acquire);
+                if (tail - cached_head_ == Capacity) return false;
+            }
+            slots_[tail & MASK] = value;
+            tail_.store(tail + 1, std::memory_order_release);
+            return true;
+        }
+
+        // Consumer only. Returns false when there is nothing to take.
+        bool pop(T &out) noexcept {
+            const size_t head = head_.load(std::memory_order_relaxed);
+            if (head == cached_tail_) {
+                cached_tail_ = tail_.load(std::memory_order_acquire);
+                if (head == cached_tail_) return false;
+            }
+            out = slots_[head & MASK];
+            head_.store(head + 1, std::memory_order_release);
+            return true;
+        }
+
+        [[nodiscard]] static constexpr size_t capacity() noexcept { return Capacity; }
+    };
+}
@@ -0,0 +1,99 @@
+#pragma once
+#include <chrono>
+#include <mutex>
+#include <vector>
+#include <string>
+#include <ostream>
+#include <iomanip>
+#include <algorithm>
+
+namespace core {
+    // Wall-clock timeline of startup stages. Stages may be recorded from any thread;
+    // times are milliseconds since the profile was created.
+    class StartupProfile {
+        using Clock = std::chrono::steady_clock;
+
+        struct Stage {
+            std::string name;
+            std::string thread;
+            double start_ms;
+            double end_ms;
+        };
+
+        Clock::time_point origin_{Clock::now()};
+        mutable std::mutex mutex_;
+        std::vector<Stage> stages_;
+
+    public:
+        class Scope {
+            StartupProfile &profile_;
+            const char *name_;
+            const char *thread_;
+            double start_ms_;
+
+        public:
+            Scope(StartupProfile &profile, const char *name, const char *thread)
+                : profile_(profile), name_(name), thread_(thread), start_ms_(profile.elapsedMs()) {
+            }
+
+            ~Scope() {
+                profile_.record(name_, thread_, start_ms_, profile_.elapsedMs());
+            }
+
+            Scope(const Scope &) = delete;
+
+            Scope &operator=(const Scope &) = delete;
+        };
+
+        [[nodiscard]] double elapsedMs() const {
+            return std::chrono::duration<double, std::milli>(Clock::now() - origin_).count();
+        }
+
+        void record(std::string name, std::string thread, const double start_ms, const double end_ms) {
+            std::lock_guard lock(mutex_);
+            stages_.push_back({std::move(name), std::move(thread), start_ms, end_ms});
+        }
+
+        // A zero-length stage, e.g. "first-frame".
+        void mark(std::string name, std::string thread) {
+            const double now = elapsedMs();
+            record(std::move(name), std::move(thread), now, now);
+        }
+
+        void print(std::ostream &out) const {
+            std::lock_guard lock(mutex_);
+            if (stages_.empty()) return;
+
+            std::vector<Stage> stages = stages_;
+            std::ranges::stable_sort(stages, {}, &Stage::start_ms);
+
+            double total_ms = 0.0;
+            for (const auto &stage: stages) {
+                total_ms = std::max(total_ms, stage.end_ms);
+            }
+
+            constexpr int BAR_WIDTH = 40;
+            const auto column = [&](const double ms) {
+                return total_ms > 0.0 ? static_cast<int>(ms / total_ms * (BAR_WIDTH - 1) + 0.5) : 0;
+            };
+
+            const std::ios_base::fmtflags flags = out.flags();
+            const std::streamsize precision = out.precision();
+
+            out << "Startup timeline (" << std::fixed << std::setprecision(1) << total_ms << " ms):\n";
+            for (const auto &stage: stages) {
+                const int first = column(stage.start_ms);
+                const int last = std::max(first, column(stage.end_ms));
+
+                std::string bar(BAR_WIDTH, ' ');
+                std::fill(bar.begin() + first, bar.begin() + last + 1, stage.end_ms > stage.start_ms ? '#' : '|');
+
+                out << "  " << std::left << std::setw(14) << stage.name << std::setw(8) << stage.thread
+                        << std::right << std::setw(8) << stage.start_ms << " .." << std::setw(8) << stage.end_ms
+                        << "  [" << bar << "]\n";
+            }
+            out.flags(flags);
+            out.precision(precision);
+        }
+    };
+}
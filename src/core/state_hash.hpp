@@ -0,0 +1,157 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <cerrno>
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+#include "math.hpp"
+
+namespace core {
+    // Running 64-bit hash of simulation state, fed one field at a time. Each field is
+    // keyed by its position and multiplied by an odd constant, and the products are
+    // summed, so the multiplies do not wait on each other and a field costs about a cycle;
+    // any single changed field changes the sum. Meant for catching accidental divergence,
+    // not tampering. Floats go in by bit pattern, so 0.0 and -0.0 differ, as they may
+    // downstream. Sums of single-event hashes make order-independent digests of things
+    // too large to walk every tick:
+    //     digest_ += StateHash{}.add(index).add(pos).value();
+    class StateHash {
+        static constexpr uint64_t GOLDEN = 0x9E3779B97F4A7C15ULL;
+        static constexpr uint64_t MULTIPLIER = 0xFF51AFD7ED558CCDULL;
+
+        uint64_t sum_{0};
+        uint64_t position_{GOLDEN};
+
+        void mix(const uint64_t word) noexcept {
+            sum_ += (word ^ position_) * MULTIPLIER;
+            position_ += GOLDEN;
+        }
+
+    public:
+        template<typename T>
+        StateHash &add(const T &value) noexcept {
+            if constexpr (std::is_same_v<T, Vector2>) {
+                mix(static_cast<uint64_t>(std::bit_cast<uint32_t>(value.x)) << 32 | std::bit_cast<uint32_t>(value.y));
+            } else if constexpr (std::is_same_v<T, float>) {
+                mix(std::bit_cast<uint32_t>(value));
+            } else if constexpr (std::is_same_v<T, double>) {
+                mix(std::bit_cast<uint64_t>(value));
+            } else if constexpr (std::is_integral_v<T> || std::is_enum_v<T>) {
+                mix(static_cast<uint64_t>(value));
+            } else {
+                static_assert(std::has_unique_object_representations_v<T>,
+                              "hash structs with padding or floats field by field");
+                addBytes(&value, sizeof(T));
+            }
+            return *this;
+        }
+
+        StateHash &addBytes(const void *data, const size_t size) noexcept {
+            const auto *bytes = static_cast<const uint8_t *>(data);
+            size_t offset = 0;
+            for (; offset + sizeof(uint64_t) <= size; offset += sizeof(uint64_t)) {
+                uint64_t word;
+                std::memcpy(&word, bytes + offset, sizeof(word));
+                mix(word);
+            }
+            if (offset < size) {
+                uint64_t word = 0;
+                std::memcpy(&word, bytes + offset, size - offset);
+                mix(word ^ size);
+            }
+            return *this;
+        }
+
+        // Finalized (MurmurHash3 fmix64), so nearby states give unrelated values.
+        [[nodiscard]] uint64_t value() const noexcept {
+            uint64_t h = sum_ ^ position_;
+            h ^= h >> 33;
+            h *= 0xFF51AFD7ED558CCDULL;
+            h ^= h >> 33;
+            h *= 0xC4CEB9FE1A85EC53ULL;
+            h ^= h >> 33;
+            return h;
+        }
+    };
+}
+
+namespace core::hash_log {
+    inline constexpr uint32_t MAGIC = 0x5247484C; // "RGHL"
+    inline constexpr uint32_t VERSION = 1;
+
+    inline constexpr size_t GAME_NAME_SIZE = 64;
+
+    // The header, then one u64 Game::hashState value per tick, in native byte order.
+    // Entry t follows the game's update t, counted from 0 as replay ticks are. Read by
+    // tools/hash_compare.cpp.
+    struct Header {
+        uint32_t magic{MAGIC};
+        uint32_t version{VERSION};
+        uint64_t seed{0};
+        float tick_rate{0.0f};
+        // core::SimdLevel the run's kernels were picked for.
+        uint32_t simd_level{0};
+        // NUL-padded catalog name of the game.
+        std::array<char, GAME_NAME_SIZE> game{};
+    };
+
+    static_assert(sizeof(Header) == 88, "the header is written as is and must have no padding");
+
+    // Hashes are buffered and written a block at a time; a stream write per tick would
+    // cost more than hashing the state.
+    class Writer {
+        static constexpr size_t BLOCK = 4096;
+
+        std::ofstream file_;
+        std::vector<uint64_t> pending_;
+        uint64_t ticks_{0};
+
+    public:
+        Writer(const std::string &path, const std::string_view game, const uint64_t seed, const float tick_rate,
+               const uint32_t simd_level)
+            : file_(path, std::ios::binary | std::ios::trunc) {
+            if (!file_) {
+                throw std::runtime_error("Failed to create hash log " + path + ": " + std::strerror(errno));
+            }
+
+            Header header;
+            header.seed = seed;
+            header.tick_rate = tick_rate;
+            header.simd_level = simd_level;
+            game.copy(header.game.data(), std::min(game.size(), GAME_NAME_SIZE - 1));
+            file_.write(reinterpret_cast<const char *>(&header), sizeof(header));
+            pending_.reserve(BLOCK);
+        }
+
+        ~Writer() {
+            flush();
+        }
+
+        Writer(const Writer &) = delete;
+
+        Writer &operator=(const Writer &) = delete;
+
+        void append(const uint64_t hash) {
+            pending_.push_back(hash);
+            ++ticks_;
+            if (pending_.size() == BLOCK) flush();
+        }
+
+        void flush() {
+            file_.write(reinterpret_cast<const char *>(pending_.data()),
+                        static_cast<std::streamsize>(pending_.size() * sizeof(uint64_t)));
+            pending_.clear();
+            file_.flush();
+        }
+
+        [[nodiscard]] uint64_t ticks() const noexcept { return ticks_; }
+    };
+}
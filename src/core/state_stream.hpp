@@ -0,0 +1,81 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <span>
+#include <vector>
+#include <type_traits>
+
+namespace core {
+    // Game state as a flat byte stream, for replay keyframes. Only trivially copyable
+    // values go in, in native byte order, so a snapshot is a run of memcpys and is only
+    // read back by the same build on the same platform. Struct padding is copied along,
+    // so equal states need not give equal bytes.
+    class StateWriter {
+        std::vector<uint8_t> &bytes_;
+
+    public:
+        explicit StateWriter(std::vector<uint8_t> &bytes) noexcept : bytes_(bytes) {
+        }
+
+        template<typename T>
+        void write(const T &value) {
+            static_assert(std::is_trivially_copyable_v<T>, "state is copied byte for byte");
+            const auto *data = reinterpret_cast<const uint8_t *>(&value);
+            bytes_.insert(bytes_.end(), data, data + sizeof(T));
+        }
+
+        // Count first, then the elements.
+        template<typename T>
+        void writeSpan(const std::span<const T> values) {
+            static_assert(std::is_trivially_copyable_v<T>, "state is copied byte for byte");
+            write(static_cast<uint64_t>(values.size()));
+            const auto *data = reinterpret_cast<const uint8_t *>(values.data());
+            bytes_.insert(bytes_.end(), data, data + values.size_bytes());
+        }
+    };
+
+    // Reads what a StateWriter wrote. A read past the end fails and leaves its target
+    // untouched, and so does every read after it.
+    class StateReader {
+        std::span<const uint8_t> bytes_;
+        size_t offset_{0};
+        bool failed_{false};
+
+        [[nodiscard]] bool take(void *out, const size_t size) noexcept {
+            if (failed_ || bytes_.size() - offset_ < size) {
+                failed_ = true;
+                return false;
+            }
+            std::memcpy(out, bytes_.data() + offset_, size);
+            offset_ += size;
+            return true;
+        }
+
+    public:
+        explicit StateReader(const std::span<const uint8_t> bytes) noexcept : bytes_(bytes) {
+        }
+
+        template<typename T>
+        [[nodiscard]] bool read(T &value) noexcept {
+            static_assert(std::is_trivially_copyable_v<T>, "state is copied byte for byte");
+            return take(&value, sizeof(T));
+        }
+
+        template<typename T>
+        [[nodiscard]] bool readVector(std::vector<T> &values) {
+            static_assert(std::is_trivially_copyable_v<T>, "state is copied byte for byte");
+            uint64_t count = 0;
+            if (!read(count) || count > (bytes_.size() - offset_) / sizeof(T)) {
+                failed_ = true;
+                return false;
+            }
+            values.resize(static_cast<size_t>(count));
+            return take(values.data(), values.size() * sizeof(T));
+        }
+
+        // Whether every read so far succeeded and nothing is left over.
+        [[nodiscard]] bool finished() const noexcept { return !failed_ && offset_ == bytes_.size(); }
+        [[nodiscard]] bool failed() const noexcept { return failed_; }
+    };
+}
@@ -1,15 +1,19 @@
 #pragma once
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_ttf.h>
-#include <GL/gl.h>
-#ifndef GL_CLAMP_TO_EDGE
-#define GL_CLAMP_TO_EDGE 0x812F
-#endif
 #include <string>
+#include <string_view>
 #include <unordered_map>
+#include <vector>
+#include <charconv>
 #include <cmath>
 #include <algorithm>
 #include <ranges>
+#include <span>
+#include "render_commands.hpp"
+#include "assets.hpp"
+#include "baked_font.hpp"
+#include "alloc_tracker.hpp"
 
 namespace core {
     struct Color {
@@ -27,34 +31,67 @@ namespace core {
     };
 
     class FontManager {
-        std::unordered_map<std::string, TTF_Font *> fonts_;
+        // Transparent so lookups by std::string_view do not build a std::string.
+        struct NameHash {
+            using is_transparent = void;
+
+            [[nodiscard]] size_t operator()(const std::string_view name) const noexcept {
+                return std::hash<std::string_view>{}(name);
+            }
+        };
+
+        std::unordered_map<std::string, TTF_Font *, NameHash, std::equal_to<> > fonts_;
         bool ttf_initialized_{false};
         TTF_Font *default_font_{nullptr};
 
+        // Scratch reused across calls so per-frame text stays off the heap once it has grown.
+        mutable std::string key_;
+        mutable std::string text_;
+        std::vector<Uint8> pixels_;
+
+        // Every size is opened straight from the font packed into the binary's asset
+        // archive; nothing is read from disk.
+        static TTF_Font *openDefaultFont(const int size) {
+            SDL_RWops *stream = assets::find(assets::id("fonts/default.ttf")).open();
+            if (!stream) return nullptr;
+
+            TTF_Font *font = TTF_OpenFontRW(stream, 1, size);
+            if (font) {
+                TTF_SetFontHinting(font, TTF_HINTING_NORMAL);
+            }
+            return font;
+        }
+
+        [[nodiscard]] static int pointSizeFor(const float scale) noexcept {
+            return std::clamp(static_cast<int>(24 * scale), 8, 128);
+        }
+
+        // "<name>_<size>", the key sized fonts are stored under.
+        [[nodiscard]] std::string_view sizedKey(const std::string_view font_name, const int size) const {
+            char digits[12];
+            const auto [end, error] = std::to_chars(digits, digits + sizeof(digits), size);
+            key_.assign(font_name);
+            key_ += '_';
+            key_.append(digits, end);
+            return key_;
+        }
+
+        // SDL_ttf needs NUL-terminated text.
+        [[nodiscard]] const char *terminated(const std::string_view text) const {
+            text_.assign(text);
+            return text_.c_str();
+        }
+
     public:
         FontManager() {
             if (TTF_Init() == 0) {
                 ttf_initialized_ = true;
 
-                const char *font_paths[] = {
-                    "/usr/share/fonts/truetype/dejavu/DejaVuSans-Bold.ttf",
-                    "/usr/share/fonts/TTF/DejaVuSans-Bold.ttf",
-                    "/System/Library/Fonts/Arial.ttf",
-                    "/Windows/Fonts/arial.ttf",
-                    "/usr/share/fonts/truetype/liberation/LiberationSans-Bold.ttf"
-                };
-
-                for (const char *path: font_paths) {
-                    default_font_ = TTF_OpenFont(path, 24);
-                    if (default_font_) {
-                        TTF_SetFontHinting(default_font_, TTF_HINTING_NORMAL);
-                        fonts_["default"] = default_font_;
-                        break;
-                    }
-                }
-
-                if (!default_font_) {
-                    printf("Warning: No system font found, text rendering may be limited\n");
+                default_font_ = openDefaultFont(24);
+                if (default_font_) {
+                    fonts_["default"] = default_font_;
+                } else {
+                    printf("Warning: No font packed into the asset archive, text rendering may be limited\n");
                 }
             }
         }
@@ -84,41 +121,48 @@ namespace core {
             return true;
         }
 
-        TTF_Font *getFont(const std::string &name = "default") {
+        // Opens the sized fonts for the given text scales and rasterizes printable ASCII
+        // into each one's glyph cache, so the first frames that draw text do not stall.
+        // Safe to run off the main thread before the manager is handed to a renderer.
+        void preload(const std::span<const float> scales) {
+            if (!default_font_) return;
+
+            static constexpr char GLYPHS[] =
+                    " !\"#$%&'()*+,-./0123456789:;<=>?@ABCDEFGHIJKLMNOPQRSTUVWXYZ[\\]^_`abcdefghijklmnopqrstuvwxyz{|}~";
+
+            for (const float scale: scales) {
+                const int size = pointSizeFor(scale);
+                const std::string key{sizedKey("default", size)};
+
+                TTF_Font *font = fonts_.contains(key) ? fonts_[key] : openDefaultFont(size);
+                if (!font) continue;
+                fonts_[key] = font;
+
+                if (SDL_Surface *glyphs = TTF_RenderText_Blended(font, GLYPHS, SDL_Color{255, 255, 255, 255})) {
+                    SDL_FreeSurface(glyphs);
+                }
+            }
+        }
+
+        TTF_Font *getFont(const std::string_view name = "default") {
             const auto it = fonts_.find(name);
             return it != fonts_.end() ? it->second : default_font_;
         }
 
-        void renderText(const std::string &text, const float x, const float y,
-                        const float scale, const Color &color, const std::string &font_name = "default") {
+        void renderText(RenderCommandList &commands, const std::string_view text, const float x, const float y,
+                        const float scale, const Color &color, const std::string_view font_name = "default") {
             TTF_Font *font = getFont(font_name);
             if (!font || text.empty()) return;
 
-            int target_size = static_cast<int>(24 * scale);
-            target_size = std::max(8, std::min(target_size, 128));
-
-            const std::string sized_font_key = font_name + "_" + std::to_string(target_size);
+            const int target_size = pointSizeFor(scale);
+            const std::string_view sized_font_key = sizedKey(font_name, target_size);
             TTF_Font *sized_font = getFont(sized_font_key);
 
             if (!sized_font) {
-                const char *font_paths[] = {
-                    "/usr/share/fonts/truetype/dejavu/DejaVuSans-Bold.ttf",
-                    "/usr/share/fonts/TTF/DejaVuSans-Bold.ttf",
-                    "/System/Library/Fonts/Arial.ttf",
-                    "/Windows/Fonts/arial.ttf",
-                    "/usr/share/fonts/truetype/liberation/LiberationSans-Bold.ttf"
-                };
-
-                for (const char *path: font_paths) {
-                    sized_font = TTF_OpenFont(path, target_size);
-                    if (sized_font) {
-                        TTF_SetFontHinting(sized_font, TTF_HINTING_NORMAL);
-                        fonts_[sized_font_key] = sized_font;
-                        break;
-                    }
-                }
-
-                if (!sized_font) {
+                sized_font = openDefaultFont(target_size);
+                if (sized_font) {
+                    fonts_.emplace(sized_font_key, sized_font);
+                } else {
                     sized_font = font;
                 }
             }
@@ -130,76 +174,62 @@ namespace core {
                 static_cast<Uint8>(color.a * 255)
             };
 
-            SDL_Surface *text_surface = TTF_RenderText_Blended(sized_font, text.c_str(), sdl_color);
+            SDL_Surface *text_surface = TTF_RenderText_Blended(sized_font, terminated(text), sdl_color);
             if (!text_surface) return;
 
-            GLuint texture;
-            glGenTextures(1, &texture);
-            glBindTexture(GL_TEXTURE_2D, texture);
+            const bool is_integer_scale = (scale == std::floor(scale)) && scale >= 1.0f;
+            const int ascent = TTF_FontAscent(sized_font);
+
+            const float aligned_x = std::round(x);
+            const float aligned_y = std::round(y);
+
+            const float render_y = aligned_y - static_cast<float>(ascent);
+
+            // Blended text comes back as ARGB8888; swizzle it into reused scratch rather than
+            // allocating a second surface through SDL_ConvertSurfaceFormat.
+            if (text_surface->format->format == SDL_PIXELFORMAT_ARGB8888) {
+                const int width = text_surface->w, height = text_surface->h;
+                pixels_.resize(static_cast<size_t>(width) * static_cast<size_t>(height) * 4);
+                for (int row = 0; row < height; ++row) {
+                    const auto *src = reinterpret_cast<const Uint32 *>(
+                        static_cast<const Uint8 *>(text_surface->pixels) + static_cast<size_t>(row) * static_cast<size_t>(text_surface->pitch));
+                    Uint8 *dst = pixels_.data() + static_cast<size_t>(row) * static_cast<size_t>(width) * 4;
+                    for (int col = 0; col < width; ++col) {
+                        const Uint32 px = src[col];
+                        dst[col * 4 + 0] = static_cast<Uint8>(px >> 16);
+                        dst[col * 4 + 1] = static_cast<Uint8>(px >> 8);
+                        dst[col * 4 + 2] = static_cast<Uint8>(px);
+                        dst[col * 4 + 3] = static_cast<Uint8>(px >> 24);
+                    }
+                }
+                SDL_FreeSurface(text_surface);
 
-            if (const bool is_integer_scale = (scale == std::floor(scale)) && scale >= 1.0f;
-                is_integer_scale && scale <= 4.0f) {
-                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-            } else {
-                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+                const ImageView image{pixels_.data(), width, height, width * 4};
+                commands.drawImage(image, aligned_x, render_y, color.a, is_integer_scale && scale <= 4.0f);
+                return;
             }
 
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-
             SDL_Surface *rgba_surface = SDL_ConvertSurfaceFormat(text_surface, SDL_PIXELFORMAT_RGBA32, 0);
             SDL_FreeSurface(text_surface);
+            if (!rgba_surface) return;
 
-            if (rgba_surface) {
-                glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, rgba_surface->w, rgba_surface->h,
-                             0, GL_RGBA, GL_UNSIGNED_BYTE, rgba_surface->pixels);
-
-                glEnable(GL_BLEND);
-                glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-
-                glEnable(GL_TEXTURE_2D);
-                glColor4f(1.0f, 1.0f, 1.0f, color.a);
-
-                const auto width = static_cast<float>(rgba_surface->w);
-                const auto height = static_cast<float>(rgba_surface->h);
-
-                const int ascent = TTF_FontAscent(sized_font);
-
-                const float aligned_x = std::round(x);
-                const float aligned_y = std::round(y);
-
-                const float render_y = aligned_y - static_cast<float>(ascent);
-
-                glBegin(GL_QUADS);
-                glTexCoord2f(0.0f, 1.0f);
-                glVertex2f(aligned_x, render_y);
-                glTexCoord2f(1.0f, 1.0f);
-                glVertex2f(aligned_x + width, render_y);
-                glTexCoord2f(1.0f, 0.0f);
-                glVertex2f(aligned_x + width, render_y + height);
-                glTexCoord2f(0.0f, 0.0f);
-                glVertex2f(aligned_x, render_y + height);
-                glEnd();
+            const ImageView image{
+                static_cast<const Uint8 *>(rgba_surface->pixels),
+                rgba_surface->w, rgba_surface->h, rgba_surface->pitch
+            };
+            commands.drawImage(image, aligned_x, render_y, color.a, is_integer_scale && scale <= 4.0f);
 
-                glDisable(GL_TEXTURE_2D);
-                glDisable(GL_BLEND);
-                SDL_FreeSurface(rgba_surface);
-            }
-            glDeleteTextures(1, &texture);
+            SDL_FreeSurface(rgba_surface);
         }
 
-        [[nodiscard]] float getTextWidth(const std::string &text, const float scale = 1.0f,
-                                         const std::string &font_name = "default") const {
+        [[nodiscard]] float getTextWidth(const std::string_view text, const float scale = 1.0f,
+                                         const std::string_view font_name = "default") const {
             if (!ttf_initialized_ || text.empty()) return 0.0f;
 
             int target_size = static_cast<int>(24 * scale);
             target_size = std::max(8, std::min(target_size, 128));
 
-            const std::string sized_font_key = font_name + "_" + std::to_string(target_size);
-
-            const auto sized_it = fonts_.find(sized_font_key);
+            const auto sized_it = fonts_.find(sizedKey(font_name, target_size));
             TTF_Font *font = nullptr;
             bool is_sized_font = false;
 
@@ -214,21 +244,19 @@ namespace core {
             if (!font) return 0.0f;
 
             int width;
-            TTF_SizeText(font, text.c_str(), &width, nullptr);
+            TTF_SizeText(font, terminated(text), &width, nullptr);
 
             return is_sized_font ? static_cast<float>(width) : static_cast<float>(width) * scale;
         }
 
-        [[nodiscard]] float getTextHeight(const std::string &text, const float scale = 1.0f,
-                                          const std::string &font_name = "default") const {
+        [[nodiscard]] float getTextHeight(const std::string_view text, const float scale = 1.0f,
+                                          const std::string_view font_name = "default") const {
             if (!ttf_initialized_ || text.empty()) return 0.0f;
 
             int target_size = static_cast<int>(24 * scale);
             target_size = std::max(8, std::min(target_size, 128));
 
-            const std::string sized_font_key = font_name + "_" + std::to_string(target_size);
-
-            const auto sized_it = fonts_.find(sized_font_key);
+            const auto sized_it = fonts_.find(sizedKey(font_name, target_size));
             TTF_Font *font = nullptr;
             bool is_sized_font = false;
 
@@ -243,7 +271,7 @@ namespace core {
             if (!font) return 0.0f;
 
             int height;
-            TTF_SizeText(font, text.c_str(), nullptr, &height);
+            TTF_SizeText(font, terminated(text), nullptr, &height);
 
             return is_sized_font ? static_cast<float>(height) : static_cast<float>(height) * scale;
         }
@@ -254,17 +282,22 @@ namespace core {
     };
 
     class TextRenderer {
-        FontManager &font_manager_;
+        FontManager *font_manager_;
+        RenderCommandList &commands_;
 
     public:
-        explicit TextRenderer(FontManager &fm) : font_manager_(fm) {}
+        // The font manager may be null when the baked font is compiled in.
+        TextRenderer(FontManager *fm, RenderCommandList &commands) : font_manager_(fm), commands_(commands) {}
 
-        void drawText(const std::string &text,float render_x, const float y,
+        void drawText(const std::string_view text, float render_x, const float y,
                       const float scale = 1.0f, const Color &color = Color{},
                       const TextAlign align = TextAlign::Left) const {
-            if (!font_manager_.isInitialized()) return;
+            const alloc::Scope alloc_scope{alloc::Tag::Text};
+#ifndef HAS_BAKED_FONT
+            if (!font_manager_ || !font_manager_->isInitialized()) return;
+#endif
 
-            const float text_width = font_manager_.getTextWidth(text, scale);
+            const float text_width = getTextWidth(text, scale);
 
             switch (align) {
                 case TextAlign::Center:
@@ -277,20 +310,32 @@ namespace core {
                 default:
                     break;
             }
-            font_manager_.renderText(text, render_x, y, scale, color);
+#ifdef HAS_BAKED_FONT
+            BakedFont::render(commands_, text, render_x, y, scale, color.r, color.g, color.b, color.a);
+#else
+            font_manager_->renderText(commands_, text, render_x, y, scale, color);
+#endif
         }
 
-        void drawTextCentered(const std::string &text, const float center_x, const float y,
+        void drawTextCentered(const std::string_view text, const float center_x, const float y,
                               const float scale = 1.0f, const Color &color = Color{}) const {
             drawText(text, center_x, y, scale, color, TextAlign::Center);
         }
 
-        [[nodiscard]] float getTextWidth(const std::string &text, const float scale = 1.0f) const {
-            return font_manager_.getTextWidth(text, scale);
+        [[nodiscard]] float getTextWidth(const std::string_view text, const float scale = 1.0f) const {
+#ifdef HAS_BAKED_FONT
+            return BakedFont::textWidth(text, scale);
+#else
+            return font_manager_ ? font_manager_->getTextWidth(text, scale) : 0.0f;
+#endif
         }
 
-        [[nodiscard]] float getTextHeight(const std::string &text, const float scale = 1.0f) const {
-            return font_manager_.getTextHeight(text, scale);
+        [[nodiscard]] float getTextHeight(const std::string_view text, const float scale = 1.0f) const {
+#ifdef HAS_BAKED_FONT
+            return text.empty() ? 0.0f : BakedFont::textHeight(scale);
+#else
+            return font_manager_ ? font_manager_->getTextHeight(text, scale) : 0.0f;
+#endif
         }
     };
 }
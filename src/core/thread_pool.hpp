@@ -0,0 +1,85 @@
+#pragma once
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <vector>
+#include <algorithm>
+
+namespace core {
+    // Fixed set of worker threads draining a FIFO task queue. A pool with no workers runs
+    // tasks inline on submit, which keeps single-core machines free of handoff costs.
+    // The queue is a vector drained from head_ and cleared once empty, so its storage is
+    // reused and steady-state submits do not allocate.
+    class ThreadPool {
+        std::vector<std::thread> workers_;
+        std::vector<std::function<void()> > tasks_;
+        size_t head_{0};
+        std::mutex mutex_;
+        std::condition_variable task_ready_;
+        bool stopping_{false};
+
+        void workerLoop() {
+            while (true) {
+                std::function<void()> task;
+                {
+                    std::unique_lock lock(mutex_);
+                    task_ready_.wait(lock, [this] { return stopping_ || head_ < tasks_.size(); });
+                    if (head_ == tasks_.size()) return;
+
+                    task = std::move(tasks_[head_++]);
+                    if (head_ == tasks_.size()) {
+                        tasks_.clear();
+                        head_ = 0;
+                    }
+                }
+                task();
+            }
+        }
+
+    public:
+        explicit ThreadPool(const size_t workers) {
+            workers_.reserve(workers);
+            for (size_t i = 0; i < workers; ++i) {
+                workers_.emplace_back([this] { workerLoop(); });
+            }
+        }
+
+        ~ThreadPool() {
+            {
+                std::lock_guard lock(mutex_);
+                stopping_ = true;
+            }
+            task_ready_.notify_all();
+            for (auto &worker: workers_) {
+                worker.join();
+            }
+        }
+
+        ThreadPool(const ThreadPool &) = delete;
+
+        ThreadPool &operator=(const ThreadPool &) = delete;
+
+        void submit(std::function<void()> task) {
+            if (workers_.empty()) {
+                task();
+                return;
+            }
+            {
+                std::lock_guard lock(mutex_);
+                tasks_.push_back(std::move(task));
+            }
+            task_ready_.notify_one();
+        }
+
+        [[nodiscard]] size_t workerCount() const noexcept {
+            return workers_.size();
+        }
+
+        // Process-wide pool sized to leave one hardware thread for the main loop.
+        static ThreadPool &shared() {
+            static ThreadPool pool(std::max(1u, std::thread::hardware_concurrency()) - 1);
+            return pool;
+        }
+    };
+}
@@ -1,160 +1,295 @@
 #pragma once
 #include "../../core/game.hpp"
-#include "../../core/entity.hpp"
 #include "../../core/math.hpp"
+#include "../../core/collision.hpp"
+#include "../../core/components.hpp"
+#include "../../core/ecs.hpp"
+#include "../../core/thread_pool.hpp"
 #include "../../core/input.hpp"
 #include "../../core/renderer.hpp"
+#include "../../core/particles.hpp"
+#include "../../core/random.hpp"
+#include "../../core/state_stream.hpp"
+#include "../../core/state_hash.hpp"
+#include "../../core/audio.hpp"
+#include "../../core/alloc_tracker.hpp"
 #include <vector>
-#include <memory>
-#include <random>
+#include <array>
 #include <algorithm>
+#include <memory>
 
 namespace games::flappy_bird {
-    class Bird final : public core::Entity {
-    public:
+    struct BirdBody {
         float velocity_y{0.0f};
+        core::Vector2 prev_pos{};
+
+        static constexpr core::Vector2 START{100.0f, 300.0f};
+        static constexpr core::Vector2 SIZE{20.0f, 20.0f};
         static constexpr float GRAVITY = -800.0f;
         static constexpr float JUMP_STRENGTH = 350.0f;
 
-        Bird() : Entity({100.0f, 300.0f}, {20.0f, 20.0f}) {
+        void jump() noexcept {
+            velocity_y = JUMP_STRENGTH;
         }
+    };
 
-        void update(const float dt) override {
-            velocity_y += GRAVITY * dt;
-            pos.y += velocity_y * dt;
+    struct Pipe {
+        static constexpr float WIDTH = 60.0f;
+        static constexpr float GAP_SIZE = 150.0f;
+        static constexpr float SPEED = 150.0f;
+        // Range new gaps are centered in.
+        static constexpr float GAP_CENTER_MIN = 150.0f;
+        static constexpr float GAP_CENTER_MAX = 450.0f;
+        core::Vector2 pos{0.0f, 300.0f};
+        core::Vector2 size{WIDTH, 600.0f};
+        float gap_center_y{300.0f};
+        bool scored{false};
+        bool active{true};
 
-            if (pos.y < size.y / 2) {
-                pos.y = size.y / 2;
-                velocity_y = 0.0f;
-            }
+        Pipe() = default;
 
-            if (pos.y > 600 - size.y / 2) {
-                pos.y = 600 - size.y / 2;
-                velocity_y = 0.0f;
-            }
+        Pipe(const float x, const float gap_y) : pos{x, 300.0f}, gap_center_y(gap_y) {
         }
 
-        void render() override {
-            // This will be handled by the game renderer
+        [[nodiscard]] core::AABB topBounds() const noexcept {
+            return {{pos.x - size.x / 2, gap_center_y + GAP_SIZE / 2}, {pos.x + size.x / 2, pos.y + size.y / 2}};
         }
 
-        void jump() noexcept {
-            velocity_y = JUMP_STRENGTH;
+        [[nodiscard]] core::AABB bottomBounds() const noexcept {
+            return {{pos.x - size.x / 2, pos.y - size.y / 2}, {pos.x + size.x / 2, gap_center_y - GAP_SIZE / 2}};
         }
 
-        [[nodiscard]] bool isOnGround() const noexcept {
-            return pos.y <= size.y / 2 + 1.0f;
+        void appendBounds(core::AABBSoA &boxes) const {
+            boxes.push(topBounds());
+            boxes.push(bottomBounds());
+        }
+
+        [[nodiscard]] bool isPastBird(const core::Transform &bird) const noexcept {
+            return !scored && pos.x + size.x / 2 < bird.pos.x - bird.size.x / 2;
         }
     };
 
-    class Pipe final : public core::Entity {
+    // Scheduler resources for game state that lives outside the world.
+    struct PipeResource {};
+    struct ScoreResource {};
+    struct ParticleResource {};
+
+    // Pipes enter on the right and leave on the left in spawn order, so they live in a
+    // fixed ring ordered by x: oldest (leftmost) at the head, newest at the tail.
+    class PipeQueue {
     public:
-        static constexpr float WIDTH = 60.0f;
-        static constexpr float GAP_SIZE = 150.0f;
-        float gap_center_y{};
-        bool scored{false};
+        static constexpr size_t CAPACITY = 8;
 
-        Pipe(float x, const float gap_y)
-            : Entity({x, 300.0f}, {WIDTH, 600.0f}), gap_center_y(gap_y) {
-        }
+    private:
+        static_assert((CAPACITY & (CAPACITY - 1)) == 0, "PipeQueue capacity must be a power of two");
 
-        void update(const float dt) override {
-            pos.x -= 150.0f * dt;
+        std::array<Pipe, CAPACITY> pipes_{};
+        size_t head_{0};
+        size_t tail_{0};
 
-            if (pos.x < -size.x / 2) {
-                active = false;
-            }
+    public:
+        bool push(const Pipe &pipe) noexcept {
+            if (full()) return false;
+            pipes_[tail_++ & (CAPACITY - 1)] = pipe;
+            return true;
         }
 
-        void render() override {
-            // This will be handled by the game renderer
+        void popFront() noexcept {
+            ++head_;
         }
 
-        [[nodiscard]] bool checkCollision(const Bird &bird) const noexcept {
-            if (bird.pos.x + bird.size.x / 2 < pos.x - size.x / 2 ||
-                bird.pos.x - bird.size.x / 2 > pos.x + size.x / 2) {
-                return false;
-            }
+        void clear() noexcept {
+            head_ = tail_ = 0;
+        }
 
-            const float gap_top = gap_center_y + GAP_SIZE / 2;
-            const float gap_bottom = gap_center_y - GAP_SIZE / 2;
+        // i-th live pipe counted from the head.
+        [[nodiscard]] Pipe &operator[](const size_t i) noexcept { return pipes_[(head_ + i) & (CAPACITY - 1)]; }
+        [[nodiscard]] const Pipe &operator[](const size_t i) const noexcept { return pipes_[(head_ + i) & (CAPACITY - 1)]; }
 
-            return bird.pos.y + bird.size.y / 2 > gap_top ||
-                   bird.pos.y - bird.size.y / 2 < gap_bottom;
+        [[nodiscard]] Pipe &front() noexcept { return (*this)[0]; }
+        [[nodiscard]] size_t size() const noexcept { return tail_ - head_; }
+        [[nodiscard]] bool empty() const noexcept { return head_ == tail_; }
+        [[nodiscard]] bool full() const noexcept { return size() == CAPACITY; }
+    };
+
+    inline void drawPipes(core::Renderer &renderer, const PipeQueue &pipes) {
+        renderer.setColor(0.0f, 0.8f, 0.0f);
+        for (size_t i = 0; i < pipes.size(); ++i) {
+            const Pipe &pipe = pipes[i];
+            if (pipe.active) {
+                const float top_height = (600.0f - pipe.gap_center_y - Pipe::GAP_SIZE / 2);
+                const float top_center_y = pipe.gap_center_y + Pipe::GAP_SIZE / 2 + top_height / 2;
+                renderer.drawRect(pipe.pos.x, top_center_y, pipe.size.x, top_height);
+
+                const float bottom_height = pipe.gap_center_y - Pipe::GAP_SIZE / 2;
+                const float bottom_center_y = bottom_height / 2;
+                renderer.drawRect(pipe.pos.x, bottom_center_y, pipe.size.x, bottom_height);
+            }
         }
+    }
 
-        [[nodiscard]] bool isPastBird(const Bird &bird) const noexcept {
-            return !scored && pos.x + size.x / 2 < bird.pos.x - bird.size.x / 2;
+    inline void hashPipes(core::StateHash &hash, const PipeQueue &pipes) {
+        hash.add(pipes.size());
+        for (size_t i = 0; i < pipes.size(); ++i) {
+            hash.add(pipes[i].pos).add(pipes[i].gap_center_y).add(pipes[i].scored).add(pipes[i].active);
         }
-    };
+    }
 
     class FlappyBirdGame final : public Game {
-        std::unique_ptr<Bird> bird_;
-        std::vector<std::unique_ptr<Pipe> > pipes_;
+        core::ecs::World world_;
+        core::ecs::Scheduler scheduler_;
+        core::ThreadPool &pool_{core::ThreadPool::shared()};
+        core::audio::AudioSystem &audio_{core::audio::AudioSystem::shared()};
+        core::ecs::Entity bird_{};
+        PipeQueue pipes_;
+        core::AABBSoA pipe_bounds_;
+        std::vector<uint64_t> hit_mask_;
+        std::vector<core::SweepHit> sweep_hits_;
+        core::ParticleSystem particles_{MAX_PARTICLES};
+        core::Random random_;
 
         GameState state_{GameState::Playing};
+        float tick_dt_{0.0f};
         float pipe_spawn_timer_{0.0f};
         int score_{0};
 
-        std::random_device rd_;
-        std::mt19937 gen_{rd_()};
-        std::uniform_real_distribution<float> gap_dist_{150.0f, 450.0f};
+        static constexpr size_t MAX_PARTICLES = 4096;
 
         void spawnPipe() {
-            float gap_y = gap_dist_(gen_);
-            auto pipe = std::make_unique<Pipe>(850.0f, gap_y);
-            pipes_.push_back(std::move(pipe));
+            const float gap_y = random_.uniform(Pipe::GAP_CENTER_MIN, Pipe::GAP_CENTER_MAX);
+            pipes_.push(Pipe{850.0f, gap_y});
+        }
+
+        void moveBird(core::ecs::World &world) const {
+            world.each<core::Transform, BirdBody>([dt = tick_dt_](core::Transform &transform, BirdBody &body) {
+                body.prev_pos = transform.pos;
+                body.velocity_y += BirdBody::GRAVITY * dt;
+                transform.pos.y += body.velocity_y * dt;
+
+                if (transform.pos.y < transform.size.y / 2) {
+                    transform.pos.y = transform.size.y / 2;
+                    body.velocity_y = 0.0f;
+                }
+
+                if (transform.pos.y > 600 - transform.size.y / 2) {
+                    transform.pos.y = 600 - transform.size.y / 2;
+                    body.velocity_y = 0.0f;
+                }
+            });
         }
 
-        void checkCollisions() {
-            for (const auto &pipe: pipes_) {
-                if (pipe->checkCollision(*bird_)) {
-                    state_ = GameState::GameOver;
-                    return;
+        void scrollPipes() {
+            for (size_t i = 0; i < pipes_.size(); ++i) {
+                Pipe &pipe = pipes_[i];
+                pipe.pos.x -= Pipe::SPEED * tick_dt_;
+
+                if (pipe.pos.x < -pipe.size.x / 2) {
+                    pipe.active = false;
                 }
+            }
+        }
+
+        // Pipes all scroll at the same speed, so the bird is swept once in their frame of
+        // reference: from its previous position shifted by this tick's scroll to where it is now.
+        // Only pipes whose x-range overlaps that sweep are tested, which is at most two.
+        void checkCollisions(core::ecs::World &world) {
+            const core::Transform &bird = *world.get<core::Transform>(bird_);
+            const BirdBody &body = *world.get<BirdBody>(bird_);
+
+            const core::Vector2 start = body.prev_pos + core::Vector2{-Pipe::SPEED * tick_dt_, 0.0f};
+            const float sweep_left = std::min(start.x, bird.pos.x) - bird.size.x / 2;
+            const float sweep_right = std::max(start.x, bird.pos.x) + bird.size.x / 2;
+
+            size_t first = 0;
+            for (; first < pipes_.size(); ++first) {
+                Pipe &pipe = pipes_[first];
+                if (pipe.pos.x + pipe.size.x / 2 >= sweep_left) break;
 
-                if (pipe->isPastBird(*bird_)) {
-                    pipe->scored = true;
+                if (pipe.isPastBird(bird)) {
+                    pipe.scored = true;
                     score_++;
                 }
             }
 
-            if (bird_->isOnGround() || bird_->pos.y >= 600 - bird_->size.y / 2) {
+            pipe_bounds_.clear();
+            for (size_t i = first; i < pipes_.size(); ++i) {
+                const Pipe &pipe = pipes_[i];
+                if (pipe.pos.x - pipe.size.x / 2 > sweep_right) break;
+                pipe.appendBounds(pipe_bounds_);
+            }
+
+            sweep_hits_.clear();
+            if (!pipe_bounds_.empty() &&
+                core::sweepBatch(core::AABB::fromCenter(start, bird.size), bird.pos - start,
+                                 pipe_bounds_, hit_mask_, sweep_hits_)) {
+                state_ = GameState::GameOver;
+                particles_.emit(core::particle_presets::EXPLOSION, bird.pos);
+                return;
+            }
+
+            const bool on_ground = bird.pos.y <= bird.size.y / 2 + 1.0f;
+            if (on_ground || bird.pos.y >= 600 - bird.size.y / 2) {
                 state_ = GameState::GameOver;
+                particles_.emit(core::particle_presets::EXPLOSION, bird.pos);
             }
         }
 
         void cleanupPipes() {
-            std::erase_if(pipes_,
-                          [](const auto &pipe) { return !pipe->active; });
+            while (!pipes_.empty() && !pipes_.front().active) {
+                pipes_.popFront();
+            }
+        }
+
+        void registerSystems() {
+            using core::ecs::Access;
+
+            scheduler_.add("move-bird", Access{}.write<core::Transform, BirdBody>(),
+                           [this](core::ecs::World &world) { moveBird(world); });
+            scheduler_.add("scroll-pipes", Access{}.write<PipeResource>(),
+                           [this](core::ecs::World &) { scrollPipes(); });
+            scheduler_.add("collide", Access{}.read<core::Transform, BirdBody>().write<PipeResource, ScoreResource, ParticleResource>(),
+                           [this](core::ecs::World &world) {
+                               const core::alloc::Scope alloc_scope{core::alloc::Tag::Collision};
+                               checkCollisions(world);
+                               cleanupPipes();
+                           });
+            scheduler_.add("particles", Access{}.write<ParticleResource>(),
+                           [this](core::ecs::World &) { particles_.update(tick_dt_); });
         }
 
     public:
-        FlappyBirdGame() {
+        explicit FlappyBirdGame(const core::Random &random) : random_(random) {
+            registerSystems();
             reset();
         }
 
         void update(const float dt, core::InputManager &input) override {
             if (state_ == GameState::Playing) {
                 if (input.isShootJustPressed()) {
-                    bird_->jump();
+                    world_.get<BirdBody>(bird_)->jump();
+                    particles_.emit(core::particle_presets::PUFF, world_.get<core::Transform>(bird_)->pos);
+                    audio_.play(core::audio::Sound::Flap);
                 }
 
-                bird_->update(dt);
-
                 pipe_spawn_timer_ += dt;
                 if (pipe_spawn_timer_ > 2.5f) {
                     spawnPipe();
                     pipe_spawn_timer_ = 0.0f;
                 }
 
-                for (const auto &pipe: pipes_) {
-                    pipe->update(dt);
-                }
+                tick_dt_ = dt;
+                const int score_before = score_;
+                scheduler_.run(world_, pool_);
+
+                // Systems may run on pool threads, so their sounds are posted from here.
+                if (score_ > score_before) audio_.play(core::audio::Sound::Score);
+                if (state_ == GameState::GameOver) audio_.play(core::audio::Sound::Hit);
 
-                checkCollisions();
-                cleanupPipes();
+                const core::Transform &bird = *world_.get<core::Transform>(bird_);
+                particles_.emit(core::particle_presets::TRAIL, bird.pos - core::Vector2{bird.size.x / 2, 0.0f});
             } else if (state_ == GameState::GameOver) {
+                // The death burst keeps playing behind the game-over panel.
+                particles_.update(dt);
                 if (input.isShootJustPressed()) {
                     reset();
                 }
@@ -162,38 +297,33 @@ namespace games::flappy_bird {
         }
 
         void render(core::Renderer &renderer) override {
-            core::Renderer::clear(0.5f, 0.8f, 1.0f);
-
-            if (state_ == GameState::Playing || state_ == GameState::GameOver) {
-                core::Renderer::setColor(0.0f, 0.8f, 0.0f);
-                for (const auto &pipe: pipes_) {
-                    if (pipe->active) {
-                        const float top_height = (600.0f - pipe->gap_center_y - Pipe::GAP_SIZE / 2);
-                        const float top_center_y = pipe->gap_center_y + Pipe::GAP_SIZE / 2 + top_height / 2;
-                        core::Renderer::drawRect(pipe->pos.x, top_center_y, pipe->size.x, top_height);
-
-                        const float bottom_height = pipe->gap_center_y - Pipe::GAP_SIZE / 2;
-                        const float bottom_center_y = bottom_height / 2;
-                        core::Renderer::drawRect(pipe->pos.x, bottom_center_y, pipe->size.x, bottom_height);
-                    }
-                }
+            renderer.clear(0.5f, 0.8f, 1.0f);
+
+            if (state_ == GameState::Playing || state_ == GameState::Paused || state_ == GameState::GameOver) {
+                drawPipes(renderer, pipes_);
+
+                particles_.fill(renderer.drawQuads(particles_.size()));
 
-                core::Renderer::setColor(1.0f, 1.0f, 0.0f);
-                core::Renderer::drawCircle(bird_->pos.x, bird_->pos.y, bird_->size.x / 2, 16);
+                renderer.setColor(1.0f, 1.0f, 0.0f);
+                world_.each<const core::Transform, const BirdBody>(
+                    [&renderer](const core::Transform &bird, const BirdBody &) {
+                        renderer.drawCircle(bird.pos.x, bird.pos.y, bird.size.x / 2, 16);
+                    });
 
-                renderer.drawText("SCORE: " + std::to_string(score_),
+                renderer.drawText(renderer.frameArena().concat("SCORE: ", score_),
                                   20.0f, 580.0f, 1.5f,
                                   core::Color{1.0f, 1.0f, 1.0f});
             }
 
             if (state_ == GameState::GameOver) {
-                core::Renderer::setColor(0.0f, 0.0f, 0.0f, 0.8f);
-                core::Renderer::drawRect(400.0f, 300.0f, 500.0f, 200.0f);
+                renderer.setLayer(core::RenderLayer::Overlay);
+                renderer.setColor(0.0f, 0.0f, 0.0f, 0.8f);
+                renderer.drawRect(400.0f, 300.0f, 500.0f, 200.0f);
 
                 renderer.drawTextCentered("GAME OVER",
                                           400.0f, 360.0f, 2.5f,
                                           core::Color{1.0f, 0.3f, 0.3f});
-                renderer.drawTextCentered("Score: " + std::to_string(score_),
+                renderer.drawTextCentered(renderer.frameArena().concat("Score: ", score_),
                                           400.0f, 320.0f, 1.8f,
                                           core::Color{1.0f, 1.0f, 0.3f});
                 renderer.drawTextCentered("Press Space or A to restart",
@@ -209,17 +339,133 @@ namespace games::flappy_bird {
             return state_;
         }
 
+        void setPaused(const bool paused) override {
+            if (paused && state_ == GameState::Playing) {
+                state_ = GameState::Paused;
+            } else if (!paused && state_ == GameState::Paused) {
+                state_ = GameState::Playing;
+            }
+        }
+
         void reset() override {
             state_ = GameState::Playing;
             score_ = 0;
             pipe_spawn_timer_ = 0.0f;
+            particles_.clear();
+            particles_.reseed(random_.split());
 
-            bird_ = std::make_unique<Bird>();
+            world_.clear();
+            bird_ = world_.create(core::Transform{BirdBody::START, BirdBody::SIZE},
+                                  BirdBody{0.0f, BirdBody::START});
             pipes_.clear();
         }
 
+        void reseed(const core::Random &random) override {
+            random_ = random;
+        }
+
         [[nodiscard]] const char *getName() const override {
             return "Flappy Bird";
         }
+
+        [[nodiscard]] std::unique_ptr<core::InputSource> createAutopilot() const override;
+
+        [[nodiscard]] bool saveState(core::StateWriter &out) const override {
+            out.write(state_);
+            out.write(pipe_spawn_timer_);
+            out.write(score_);
+            out.write(random_);
+            out.write(bird());
+            out.write(birdBody());
+            out.write(pipes_);
+            return true;
+        }
+
+        [[nodiscard]] bool loadState(core::StateReader &in) override {
+            GameState state{};
+            float pipe_spawn_timer = 0.0f;
+            int score = 0;
+            core::Random random;
+            core::Transform bird;
+            BirdBody body;
+            PipeQueue pipes;
+            if (!in.read(state) || !in.read(pipe_spawn_timer) || !in.read(score) || !in.read(random) ||
+                !in.read(bird) || !in.read(body) || !in.read(pipes) || !in.finished()) {
+                return false;
+            }
+
+            state_ = state;
+            pipe_spawn_timer_ = pipe_spawn_timer;
+            score_ = score;
+            random_ = random;
+            pipes_ = pipes;
+            particles_.clear();
+            world_.clear();
+            bird_ = world_.create(bird, body);
+            return true;
+        }
+
+        void hashState(core::StateHash &hash) const override {
+            const BirdBody &body = birdBody();
+            hash.add(state_).add(score_).add(pipe_spawn_timer_).add(random_);
+            hash.add(bird().pos).add(body.velocity_y).add(body.prev_pos);
+            hashPipes(hash, pipes_);
+        }
+
+        [[nodiscard]] const core::Transform &bird() const noexcept { return *world_.get<core::Transform>(bird_); }
+        [[nodiscard]] const BirdBody &birdBody() const noexcept { return *world_.get<BirdBody>(bird_); }
+        [[nodiscard]] const PipeQueue &pipes() const noexcept { return pipes_; }
     };
+
+    // Flaps once the bird's predicted fall would take it below the gap of the next pipe it
+    // has not yet cleared, provided the climb from the flap stays under the top of the gap.
+    class Autopilot final : public core::InputSource {
+        const FlappyBirdGame &game_;
+        bool flapped_{false};
+
+        // How far ahead the fall is predicted, and the clearance kept from the pipes.
+        static constexpr float LOOKAHEAD = 0.1f;
+        static constexpr float MARGIN = 6.0f;
+        // Height gained from a flap until the bird starts falling again.
+        static constexpr float CLIMB = BirdBody::JUMP_STRENGTH * BirdBody::JUMP_STRENGTH / (-2.0f * BirdBody::GRAVITY);
+        // With no pipe in sight the bird holds the middle of where gaps can appear.
+        static constexpr float IDLE_GAP_CENTER = (Pipe::GAP_CENTER_MIN + Pipe::GAP_CENTER_MAX) / 2;
+
+        [[nodiscard]] float nextGapCenter(const core::Transform &bird) const noexcept {
+            const PipeQueue &pipes = game_.pipes();
+            for (size_t i = 0; i < pipes.size(); ++i) {
+                const Pipe &pipe = pipes[i];
+                if (pipe.pos.x + pipe.size.x / 2 >= bird.pos.x - bird.size.x / 2) {
+                    return pipe.gap_center_y;
+                }
+            }
+            return IDLE_GAP_CENTER;
+        }
+
+    public:
+        explicit Autopilot(const FlappyBirdGame &game) : game_(game) {
+        }
+
+        void sample(core::InputState &state) override {
+            state.horizontal = 0.0f;
+            // A flap is edge-triggered, so the button is released for a tick after each one.
+            if (flapped_ || game_.getState() != GameState::Playing) {
+                state.shoot = flapped_ = false;
+                return;
+            }
+
+            const core::Transform &bird = game_.bird();
+            const float velocity = game_.birdBody().velocity_y;
+            const float gap_center = nextGapCenter(bird);
+            const float floor = gap_center - Pipe::GAP_SIZE / 2 + bird.size.y / 2 + MARGIN;
+            const float ceiling = gap_center + Pipe::GAP_SIZE / 2 - bird.size.y / 2 - MARGIN;
+
+            const float predicted = bird.pos.y + velocity * LOOKAHEAD + 0.5f * BirdBody::GRAVITY * LOOKAHEAD * LOOKAHEAD;
+            state.shoot = flapped_ = predicted < floor && bird.pos.y + CLIMB <= ceiling;
+        }
+    };
+
+    inline std::unique_ptr<core::InputSource> FlappyBirdGame::createAutopilot() const {
+        return std::make_unique<Autopilot>(*this);
+    }
 }
@@ -0,0 +1,394 @@
+#pragma once
+#include "flappy_bird.hpp"
+#include <cstdint>
+#include <cstddef>
+#include <bit>
+#include <span>
+#include <vector>
+#include <algorithm>
+
+namespace games::flappy_bird {
+    namespace detail {
+        // Lanes are padded to a multiple of this; each block's deaths land in one byte.
+        inline constexpr size_t FLOCK_LANE_BLOCK = 8;
+
+        // Every bird shares x, so the pipes bound all of them by the same band of heights.
+        // Each bird flaps once its predicted height, lookahead seconds on, drops below the
+        // next gap's center plus its own aim.
+        struct FlockLanes {
+            float *y, *vy;
+            const float *aim, *lookahead;
+            uint8_t *dead;
+        };
+
+        struct FlockStep {
+            float dt;
+            float gap_center;
+            float low, high; // a bird must stay strictly between these
+        };
+
+        using FlockKernel = void (*)(const FlockLanes &, size_t, const FlockStep &);
+
+        inline void stepFlockScalar(const FlockLanes &b, const size_t count, const FlockStep &step) noexcept {
+            for (size_t block = 0; block < count; block += FLOCK_LANE_BLOCK) {
+                unsigned bits = 0;
+                for (size_t lane = 0; lane < FLOCK_LANE_BLOCK; ++lane) {
+                    const size_t i = block + lane;
+                    float vy = b.vy[i];
+                    if (b.y[i] + vy * b.lookahead[i] < step.gap_center + b.aim[i]) {
+                        vy = BirdBody::JUMP_STRENGTH;
+                    }
+                    vy += BirdBody::GRAVITY * step.dt;
+                    const float y = b.y[i] + vy * step.dt;
+                    b.vy[i] = vy;
+                    b.y[i] = y;
+                    if (!(y > step.low && y < step.high)) bits |= 1u << lane;
+                }
+                b.dead[block / FLOCK_LANE_BLOCK] = static_cast<uint8_t>(bits);
+            }
+        }
+
+#ifdef CORE_COLLISION_X86
+        inline void stepFlockSSE2(const FlockLanes &b, const size_t count, const FlockStep &step) noexcept {
+            const __m128 dt = _mm_set1_ps(step.dt);
+            const __m128 fall = _mm_set1_ps(BirdBody::GRAVITY * step.dt);
+            const __m128 jump = _mm_set1_ps(BirdBody::JUMP_STRENGTH);
+            const __m128 center = _mm_set1_ps(step.gap_center);
+            const __m128 low = _mm_set1_ps(step.low);
+            const __m128 high = _mm_set1_ps(step.high);
+
+            const auto half = [&](const size_t i) noexcept {
+                const __m128 y = _mm_loadu_ps(b.y + i);
+                __m128 vy = _mm_loadu_ps(b.vy + i);
+                const __m128 predicted = _mm_add_ps(y, _mm_mul_ps(vy, _mm_loadu_ps(b.lookahead + i)));
+                const __m128 flap = _mm_cmplt_ps(predicted, _mm_add_ps(center, _mm_loadu_ps(b.aim + i)));
+                vy = _mm_add_ps(_mm_or_ps(_mm_and_ps(flap, jump), _mm_andnot_ps(flap, vy)), fall);
+                const __m128 moved = _mm_add_ps(y, _mm_mul_ps(vy, dt));
+                _mm_storeu_ps(b.vy + i, vy);
+                _mm_storeu_ps(b.y + i, moved);
+                return _mm_movemask_ps(_mm_and_ps(_mm_cmpgt_ps(moved, low), _mm_cmplt_ps(moved, high)));
+            };
+
+            for (size_t i = 0; i < count; i += FLOCK_LANE_BLOCK) {
+                const int alive = half(i) | half(i + 4) << 4;
+                b.dead[i / FLOCK_LANE_BLOCK] = static_cast<uint8_t>(~alive);
+            }
+        }
+
+        __attribute__((target("avx2")))
+        inline void stepFlockAVX2(const FlockLanes &b, const size_t count, const FlockStep &step) noexcept {
+            const __m256 dt = _mm256_set1_ps(step.dt);
+            const __m256 fall = _mm256_set1_ps(BirdBody::GRAVITY * step.dt);
+            const __m256 jump = _mm256_set1_ps(BirdBody::JUMP_STRENGTH);
+            const __m256 center = _mm256_set1_ps(step.gap_center);
+            const __m256 low = _mm256_set1_ps(step.low);
+            const __m256 high = _mm256_set1_ps(step.high);
+
+            for (size_t i = 0; i < count; i += FLOCK_LANE_BLOCK) {
+                const __m256 y = _mm256_loadu_ps(b.y + i);
+                __m256 vy = _mm256_loadu_ps(b.vy + i);
+                const __m256 predicted = _mm256_add_ps(y, _mm256_mul_ps(vy, _mm256_loadu_ps(b.lookahead + i)));
+                const __m256 flap = _mm256_cmp_ps(predicted, _mm256_add_ps(center, _mm256_loadu_ps(b.aim + i)), _CMP_LT_OQ);
+                vy = _mm256_add_ps(_mm256_blendv_ps(vy, jump, flap), fall);
+                const __m256 moved = _mm256_add_ps(y, _mm256_mul_ps(vy, dt));
+                _mm256_storeu_ps(b.vy + i, vy);
+                _mm256_storeu_ps(b.y + i, moved);
+
+                const __m256 alive = _mm256_and_ps(_mm256_cmp_ps(moved, low, _CMP_GT_OQ), _mm256_cmp_ps(moved, high, _CMP_LT_OQ));
+                b.dead[i / FLOCK_LANE_BLOCK] = static_cast<uint8_t>(~_mm256_movemask_ps(alive));
+            }
+        }
+#endif
+
+        [[nodiscard]] inline FlockKernel flockKernelFor(const core::SimdLevel level) noexcept {
+            switch (level) {
+#ifdef CORE_COLLISION_X86
+                case core::SimdLevel::AVX2:
+                    return stepFlockAVX2;
+                case core::SimdLevel::SSE2:
+                    return stepFlockSSE2;
+#endif
+                default:
+                    return stepFlockScalar;
+            }
+        }
+    }
+
+    // Fixed-capacity flock of birds stored as separate lanes, live birds packed at the
+    // front. A step runs over whole SIMD blocks and records deaths as bits; removing the
+    // dead moves the last live bird into each hole, so nothing is ever reallocated.
+    class BirdFlock {
+        size_t capacity_;
+        size_t size_{0};
+        std::vector<float> y_, vy_, aim_, lookahead_;
+        std::vector<uint8_t> dead_;
+        detail::FlockKernel kernel_;
+        // Every bird spawned and every death since the last clear, with where it happened;
+        // walking the live lanes each tick would cost as much as stepping them.
+        uint64_t digest_{0};
+
+        [[nodiscard]] size_t blocks() const noexcept {
+            return (size_ + detail::FLOCK_LANE_BLOCK - 1) / detail::FLOCK_LANE_BLOCK;
+        }
+
+        void move(const size_t from, const size_t to) noexcept {
+            y_[to] = y_[from];
+            vy_[to] = vy_[from];
+            aim_[to] = aim_[from];
+            lookahead_[to] = lookahead_[from];
+        }
+
+    public:
+        explicit BirdFlock(const size_t capacity, const core::SimdLevel level = core::detectSimdLevel())
+            : capacity_(capacity), kernel_(detail::flockKernelFor(level)) {
+            const size_t padded = (capacity + detail::FLOCK_LANE_BLOCK - 1) / detail::FLOCK_LANE_BLOCK *
+                                  detail::FLOCK_LANE_BLOCK;
+            for (auto *lane: {&y_, &vy_, &aim_, &lookahead_}) {
+                lane->resize(padded);
+            }
+            dead_.resize(padded / detail::FLOCK_LANE_BLOCK);
+        }
+
+        // Adds a bird at the start position; a full flock ignores it.
+        void spawn(const float aim, const float lookahead) noexcept {
+            if (size_ == capacity_) return;
+            y_[size_] = BirdBody::START.y;
+            vy_[size_] = 0.0f;
+            aim_[size_] = aim;
+            lookahead_[size_] = lookahead;
+            ++size_;
+            digest_ += core::StateHash{}.add(aim).add(lookahead).value();
+        }
+
+        // Moves every bird one tick and returns how many left the band. The dead stay in
+        // place until removeDead(), so the caller can still read them.
+        size_t step(const detail::FlockStep &step) noexcept {
+            if (size_ == 0) return 0;
+
+            const detail::FlockLanes lanes{y_.data(), vy_.data(), aim_.data(), lookahead_.data(), dead_.data()};
+            const size_t count = blocks();
+            kernel_(lanes, count * detail::FLOCK_LANE_BLOCK, step);
+
+            // Padding lanes past the last bird hold garbage.
+            if (const size_t tail = size_ % detail::FLOCK_LANE_BLOCK; tail != 0) {
+                dead_[count - 1] &= static_cast<uint8_t>((1u << tail) - 1);
+            }
+
+            size_t deaths = 0;
+            for (size_t block = 0; block < count; ++block) {
+                deaths += static_cast<size_t>(std::popcount(dead_[block]));
+            }
+            return deaths;
+        }
+
+        // Walks the deaths from the back, so the bird moved into each hole is always alive.
+        void removeDead() noexcept {
+            for (size_t block = blocks(); block-- > 0;) {
+                for (unsigned bits = dead_[block]; bits != 0;) {
+                    const unsigned lane = static_cast<unsigned>(std::bit_width(bits)) - 1;
+                    bits &= ~(1u << lane);
+                    const size_t bird = block * detail::FLOCK_LANE_BLOCK + lane;
+                    digest_ += core::StateHash{}.add(y_[bird]).add(vy_[bird]).add(aim_[bird]).value();
+                    move(--size_, bird);
+                }
+                dead_[block] = 0;
+            }
+        }
+
+        // Writes one quad per live bird; out must hold size() quads.
+        void fill(const std::span<core::Quad> out, const Uint8 alpha) const noexcept {
+            for (size_t i = 0; i < size_; ++i) {
+                out[i] = {BirdBody::START.x, y_[i], BirdBody::SIZE.x, 255, 255, 0, alpha};
+            }
+        }
+
+        void clear() noexcept {
+            size_ = 0;
+            digest_ = 0;
+        }
+
+        [[nodiscard]] std::span<const float> aims() const noexcept { return {aim_.data(), size_}; }
+        [[nodiscard]] std::span<const float> lookaheads() const noexcept { return {lookahead_.data(), size_}; }
+        [[nodiscard]] size_t size() const noexcept { return size_; }
+        [[nodiscard]] uint64_t digest() const noexcept { return digest_; }
+        [[nodiscard]] size_t capacity() const noexcept { return capacity_; }
+        [[nodiscard]] bool empty() const noexcept { return size_ == 0; }
+    };
+
+    // Flappy Bird for a whole flock sharing one pipe sequence. Each bird follows its own
+    // aim and lookahead; when the last of a generation die together, the next generation
+    // is bred from them with a little mutation, so the flock learns the course over time.
+    class PopulationGame final : public Game {
+        BirdFlock flock_;
+        std::vector<float> parent_aims_, parent_lookaheads_;
+        PipeQueue pipes_;
+
+        GameState state_{GameState::Playing};
+        float pipe_spawn_timer_{0.0f};
+        int score_{0};
+        int best_score_{0};
+        int generation_{1};
+
+        core::Random random_;
+
+        // Range of the first generation's genes and the spread of each mutation.
+        static constexpr float AIM_MIN = -60.0f, AIM_MAX = 40.0f, AIM_MUTATION = 8.0f;
+        static constexpr float LOOKAHEAD_MAX = 0.3f, LOOKAHEAD_MUTATION = 0.02f;
+        static constexpr float IDLE_GAP_CENTER = (Pipe::GAP_CENTER_MIN + Pipe::GAP_CENTER_MAX) / 2;
+
+        [[nodiscard]] detail::FlockStep flockStep(const float dt) const noexcept {
+            constexpr float half = BirdBody::SIZE.y / 2;
+            const core::Transform bird{BirdBody::START, BirdBody::SIZE};
+            detail::FlockStep step{dt, IDLE_GAP_CENTER, half + 1.0f, 600.0f - half};
+
+            // Birds are tested over this tick's scroll, as FlappyBirdGame sweeps its bird.
+            const float left = bird.pos.x - half - Pipe::SPEED * dt;
+            const float right = bird.pos.x + half;
+            bool steering = false;
+            for (size_t i = 0; i < pipes_.size(); ++i) {
+                const Pipe &pipe = pipes_[i];
+                if (pipe.pos.x + pipe.size.x / 2 < left) continue;
+
+                if (!steering && pipe.pos.x + pipe.size.x / 2 >= bird.pos.x - half) {
+                    step.gap_center = pipe.gap_center_y;
+                    steering = true;
+                }
+                if (pipe.pos.x - pipe.size.x / 2 <= right) {
+                    step.low = std::max(step.low, pipe.gap_center_y - Pipe::GAP_SIZE / 2 + half);
+                    step.high = std::min(step.high, pipe.gap_center_y + Pipe::GAP_SIZE / 2 - half);
+                }
+            }
+            return step;
+        }
+
+        void scrollPipes(const float dt) {
+            const core::Transform bird{BirdBody::START, BirdBody::SIZE};
+            for (size_t i = 0; i < pipes_.size(); ++i) {
+                Pipe &pipe = pipes_[i];
+                pipe.pos.x -= Pipe::SPEED * dt;
+                if (pipe.isPastBird(bird)) {
+                    pipe.scored = true;
+                    ++score_;
+                }
+            }
+            while (!pipes_.empty() && pipes_.front().pos.x < -pipes_.front().size.x / 2) {
+                pipes_.popFront();
+            }
+        }
+
+        void seedGeneration() {
+            while (flock_.size() < flock_.capacity()) {
+                flock_.spawn(random_.uniform(AIM_MIN, AIM_MAX), random_.uniform(0.0f, LOOKAHEAD_MAX));
+            }
+        }
+
+        // Triangular noise in (-spread, spread), drawn the same way on every platform.
+        [[nodiscard]] float mutation(const float spread) noexcept {
+            return (random_.unit() - random_.unit()) * spread;
+        }
+
+        // The flock died in one tick, so every bird in it was among the last survivors.
+        void breedGeneration() {
+            const size_t parents = flock_.size();
+            std::ranges::copy(flock_.aims(), parent_aims_.begin());
+            std::ranges::copy(flock_.lookaheads(), parent_lookaheads_.begin());
+
+            flock_.clear();
+            while (flock_.size() < flock_.capacity()) {
+                const size_t parent = random_.below(static_cast<uint32_t>(parents));
+                flock_.spawn(parent_aims_[parent] + mutation(AIM_MUTATION),
+                             std::clamp(parent_lookaheads_[parent] + mutation(LOOKAHEAD_MUTATION), 0.0f, LOOKAHEAD_MAX));
+            }
+            startRound();
+            ++generation_;
+        }
+
+        void startRound() {
+            best_score_ = std::max(best_score_, score_);
+            score_ = 0;
+            pipe_spawn_timer_ = 0.0f;
+            pipes_.clear();
+        }
+
+    public:
+        static constexpr size_t DEFAULT_BIRDS = 100'000;
+
+        explicit PopulationGame(const core::Random &random, const size_t birds = DEFAULT_BIRDS)
+            : flock_(birds), parent_aims_(birds), parent_lookaheads_(birds), random_(random) {
+            reset();
+        }
+
+        void update(const float dt, core::InputManager &) override {
+            if (state_ != GameState::Playing) return;
+
+            pipe_spawn_timer_ += dt;
+            if (pipe_spawn_timer_ > 2.5f) {
+                pipes_.push(Pipe{850.0f, random_.uniform(Pipe::GAP_CENTER_MIN, Pipe::GAP_CENTER_MAX)});
+                pipe_spawn_timer_ = 0.0f;
+            }
+            scrollPipes(dt);
+
+            if (const size_t deaths = flock_.step(flockStep(dt)); deaths == flock_.size()) {
+                breedGeneration();
+            } else if (deaths > 0) {
+                flock_.removeDead();
+            }
+        }
+
+        void render(core::Renderer &renderer) override {
+            renderer.clear(0.5f, 0.8f, 1.0f);
+            drawPipes(renderer, pipes_);
+
+            // Birds overlap heavily, so each is faint and crowds read as bright.
+            flock_.fill(renderer.drawQuads(flock_.size()), 96);
+
+            renderer.setLayer(core::RenderLayer::Overlay);
+            renderer.drawText(renderer.frameArena().concat("SCORE: ", score_, "  BEST: ", best_score_),
+                              20.0f, 580.0f, 1.5f,
+                              core::Color{1.0f, 1.0f, 1.0f});
+            renderer.drawText(renderer.frameArena().concat("GENERATION: ", generation_,
+                                                           "  ALIVE: ", flock_.size(), " / ", flock_.capacity()),
+                              20.0f, 555.0f, 1.0f,
+                              core::Color{1.0f, 1.0f, 1.0f});
+        }
+
+        [[nodiscard]] GameState getState() const override {
+            return state_;
+        }
+
+        void setPaused(const bool paused) override {
+            if (paused && state_ == GameState::Playing) {
+                state_ = GameState::Paused;
+            } else if (!paused && state_ == GameState::Paused) {
+                state_ = GameState::Playing;
+            }
+        }
+
+        void reset() override {
+            state_ = GameState::Playing;
+            generation_ = 1;
+            score_ = best_score_ = 0;
+            flock_.clear();
+            seedGeneration();
+            startRound();
+        }
+
+        void reseed(const core::Random &random) override {
+            random_ = random;
+        }
+
+        [[nodiscard]] const char *getName() const override {
+            return "Flappy Bird Population";
+        }
+
+        void hashState(core::StateHash &hash) const override {
+            hash.add(state_).add(score_).add(best_score_).add(generation_).add(pipe_spawn_timer_).add(random_);
+            hash.add(flock_.size()).add(flock_.digest());
+            hashPipes(hash, pipes_);
+        }
+
+        [[nodiscard]] const BirdFlock &flock() const noexcept { return flock_; }
+        [[nodiscard]] int score() const noexcept { return score_; }
+        [[nodiscard]] int generation() const noexcept { return generation_; }
+    };
+}
@@ -1,239 +1,517 @@
 #pragma once
 #include "../../core/game.hpp"
-#include "../../core/entity.hpp"
 #include "../../core/math.hpp"
+#include "../../core/collision.hpp"
+#include "../../core/components.hpp"
+#include "../../core/ecs.hpp"
+#include "../../core/thread_pool.hpp"
 #include "../../core/input.hpp"
 #include "../../core/renderer.hpp"
+#include "../../core/particles.hpp"
+#include "../../core/random.hpp"
+#include "../../core/state_stream.hpp"
+#include "../../core/state_hash.hpp"
+#include "../../core/audio.hpp"
+#include "../../core/alloc_tracker.hpp"
 #include <vector>
-#include <memory>
 #include <algorithm>
+#include <cmath>
+#include <memory>
+#include <optional>
+#include <tuple>
 
 namespace games::space_invaders {
-    class Player final : public core::Entity {
-    public:
-        core::Vector2 velocity{};
+    struct PlayerShip {
         float fire_cooldown{0.0f};
 
-        explicit Player(const float screen_width)
-            : Entity({screen_width / 2.0f, 50.0f}, {20.0f, 20.0f}) {
+        static constexpr core::Vector2 SIZE{20.0f, 20.0f};
+        static constexpr float SPEED = 200.0f;
+        static constexpr float FIRE_COOLDOWN = 0.2f;
+    };
+
+    // Formation size and firing. The defaults are the normal game; the stress scenario
+    // scales them up to size hardware and to catch scaling regressions in collision and
+    // rendering.
+    struct Settings {
+        int rows{5};
+        int cols{10};
+        // Shots per second fired on their own, spread across the screen; 0 fires from
+        // the ship on the shoot button.
+        float auto_fire_rate{0.0f};
+        float bullet_speed{300.0f};
+        // The formation respawns instead of ending the game when it lands.
+        bool endless{false};
+
+        [[nodiscard]] static constexpr Settings stress() noexcept {
+            return {200, 500, 50000.0f, 300.0f, true};
         }
+    };
 
-        void update(const float dt) override {
-            pos += velocity * dt;
+    struct Projectile {
+        core::Vector2 prev_pos{};
+        bool from_player{true};
+        bool spent{false};
 
-            // Keep player on screen
-            if (pos.x < size.x / 2) pos.x = size.x / 2;
-            if (pos.x > 800 - size.x / 2) pos.x = 800 - size.x / 2;
+        static constexpr core::Vector2 SIZE{2.0f, 5.0f};
+    };
 
-            fire_cooldown = std::max(0.0f, fire_cooldown - dt);
-        }
+    // Scheduler resources for game state that lives outside the world.
+    struct FormationResource {};
+    struct ScoreResource {};
+    struct ParticleResource {};
 
-        void render() override {
-            // This will be handled by the game renderer
-        }
+    struct Invader {
+        core::Vector2 offset{};
+        bool active{true};
+    };
+
+    // Invaders live at fixed offsets from a shared origin; marching moves only the origin.
+    // Live column/row counts keep the extent of the surviving invaders current as they
+    // die, so stepping and edge tests never walk the grid.
+    class InvaderFormation {
+        std::vector<Invader> invaders_;
+        std::vector<int> column_alive_;
+        std::vector<int> row_alive_;
+        core::Vector2 origin_{};
+        core::Vector2 spacing_{};
+        core::Vector2 size_{INVADER_SIZE};
+        int rows_{0}, cols_{0};
+        int first_column_{0}, last_column_{0}, bottom_row_{0};
+        size_t alive_{0};
+
+    public:
+        static constexpr core::Vector2 INVADER_SIZE{15.0f, 15.0f};
+
+        // Invaders shrink with their spacing so large grids still fit the screen.
+        void create(const int rows, const int cols, const core::Vector2 origin, const core::Vector2 spacing) {
+            rows_ = rows;
+            cols_ = cols;
+            origin_ = origin;
+            spacing_ = spacing;
+            size_ = {std::min(INVADER_SIZE.x, spacing.x * 0.8f), std::min(INVADER_SIZE.y, spacing.y * 0.8f)};
+
+            invaders_.clear();
+            invaders_.reserve(static_cast<size_t>(rows) * static_cast<size_t>(cols));
+            column_alive_.assign(static_cast<size_t>(cols), rows);
+            row_alive_.assign(static_cast<size_t>(rows), cols);
+
+            for (int row = 0; row < rows; ++row) {
+                for (int col = 0; col < cols; ++col) {
+                    const core::Vector2 offset{static_cast<float>(col) * spacing.x, -static_cast<float>(row) * spacing.y};
+                    invaders_.push_back({offset, true});
+                }
+            }
 
-        [[nodiscard]] bool canFire() const noexcept {
-            return fire_cooldown <= 0.0f;
+            first_column_ = 0;
+            last_column_ = cols - 1;
+            bottom_row_ = rows - 1;
+            alive_ = invaders_.size();
         }
 
-        void fired() noexcept {
-            fire_cooldown = 0.2f;
+        void kill(const size_t index) {
+            Invader &invader = invaders_[index];
+            if (!invader.active) return;
+
+            invader.active = false;
+            --alive_;
+
+            const auto row = static_cast<size_t>(index) / static_cast<size_t>(cols_);
+            const auto col = static_cast<size_t>(index) % static_cast<size_t>(cols_);
+            --column_alive_[col];
+            --row_alive_[row];
+
+            while (first_column_ < last_column_ && column_alive_[static_cast<size_t>(first_column_)] == 0) {
+                ++first_column_;
+            }
+            while (last_column_ > first_column_ && column_alive_[static_cast<size_t>(last_column_)] == 0) {
+                --last_column_;
+            }
+            while (bottom_row_ > 0 && row_alive_[static_cast<size_t>(bottom_row_)] == 0) {
+                --bottom_row_;
+            }
         }
-    };
 
-    class Invader final : public core::Entity {
-    public:
-        core::Vector2 velocity{};
+        void translate(const core::Vector2 delta) noexcept {
+            origin_ += delta;
+        }
 
-        explicit Invader(const core::Vector2 position)
-            : Entity(position, {15.0f, 15.0f}), velocity({20.0f, 0.0f}) {
+        // Extents of the surviving invaders' centers in screen space.
+        [[nodiscard]] float liveLeft() const noexcept {
+            return origin_.x + static_cast<float>(first_column_) * spacing_.x;
         }
 
-        void update(const float dt) override {
-            pos += velocity * dt;
+        [[nodiscard]] float liveRight() const noexcept {
+            return origin_.x + static_cast<float>(last_column_) * spacing_.x;
         }
 
-        void render() override {
-            // This will be handled by the game renderer
+        [[nodiscard]] float liveBottom() const noexcept {
+            return origin_.y - static_cast<float>(bottom_row_) * spacing_.y;
         }
-    };
 
-    class Bullet final : public core::Entity {
-    public:
-        core::Vector2 velocity{};
-        bool is_player_bullet{true};
+        // Surviving invaders crossed by box moving by delta, appended in time-of-impact order.
+        // Only the rows and columns under the swept box are visited, so the cost of a test
+        // does not grow with the size of the formation.
+        bool sweepTest(const core::AABB &box, const core::Vector2 delta, std::vector<core::SweepHit> &hits) const {
+            if (invaders_.empty()) return false;
+
+            const core::AABB local = box.translated(core::Vector2{} - origin_);
+            const float min_x = std::min(local.min.x, local.min.x + delta.x) - size_.x / 2;
+            const float max_x = std::max(local.max.x, local.max.x + delta.x) + size_.x / 2;
+            const float min_y = std::min(local.min.y, local.min.y + delta.y) - size_.y / 2;
+            const float max_y = std::max(local.max.y, local.max.y + delta.y) + size_.y / 2;
+
+            // Columns sit at x = col * spacing.x, rows at y = -row * spacing.y. The range is
+            // rounded outwards so boxes just touching an edge are still tested exactly.
+            const int first_col = std::max(0, static_cast<int>(std::floor(min_x / spacing_.x)));
+            const int last_col = std::min(cols_ - 1, static_cast<int>(std::ceil(max_x / spacing_.x)));
+            const int first_row = std::max(0, static_cast<int>(std::floor(-max_y / spacing_.y)));
+            const int last_row = std::min(rows_ - 1, static_cast<int>(std::ceil(-min_y / spacing_.y)));
+            if (first_col > last_col || first_row > last_row) return false;
+
+            const size_t first = hits.size();
+            for (int row = first_row; row <= last_row; ++row) {
+                for (int col = first_col; col <= last_col; ++col) {
+                    const size_t index = static_cast<size_t>(row) * static_cast<size_t>(cols_) + static_cast<size_t>(col);
+                    const Invader &invader = invaders_[index];
+                    if (!invader.active) continue;
+
+                    if (const auto time = core::sweep(local, delta, core::AABB::fromCenter(invader.offset, size_))) {
+                        hits.push_back({index, *time});
+                    }
+                }
+            }
 
-        Bullet(const core::Vector2 position, const core::Vector2 vel, const bool player_bullet = true)
-            : Entity(position, {2.0f, 5.0f}), velocity(vel), is_player_bullet(player_bullet) {
+            std::sort(hits.begin() + static_cast<std::ptrdiff_t>(first), hits.end(), core::earlierHit);
+            return hits.size() > first;
         }
 
-        void update(const float dt) override {
-            pos += velocity * dt;
+        // Screen position of the invader closest to x in the lowest live row, the row that
+        // lands first.
+        [[nodiscard]] std::optional<core::Vector2> lowestNear(const float x) const noexcept {
+            if (alive_ == 0) return std::nullopt;
 
-            if (pos.y < 0 || pos.y > 600) {
-                active = false;
+            std::optional<core::Vector2> closest;
+            const size_t row_start = static_cast<size_t>(bottom_row_) * static_cast<size_t>(cols_);
+            for (int col = first_column_; col <= last_column_; ++col) {
+                const Invader &invader = invaders_[row_start + static_cast<size_t>(col)];
+                if (!invader.active) continue;
+
+                const core::Vector2 at = origin_ + invader.offset;
+                if (!closest || std::abs(at.x - x) < std::abs(closest->x - x)) {
+                    closest = at;
+                }
             }
+            return closest;
         }
 
-        void render() override {
-            // This will be handled by the game renderer
+        void save(core::StateWriter &out) const {
+            out.write(origin_);
+            out.write(spacing_);
+            out.write(size_);
+            for (const int value: {rows_, cols_, first_column_, last_column_, bottom_row_}) {
+                out.write(value);
+            }
+            out.write(static_cast<uint64_t>(alive_));
+            out.writeSpan(std::span{invaders_});
+            out.writeSpan(std::span{column_alive_});
+            out.writeSpan(std::span{row_alive_});
         }
+
+        [[nodiscard]] bool load(core::StateReader &in) {
+            InvaderFormation loaded;
+            uint64_t alive = 0;
+            if (!in.read(loaded.origin_) || !in.read(loaded.spacing_) || !in.read(loaded.size_) ||
+                !in.read(loaded.rows_) || !in.read(loaded.cols_) || !in.read(loaded.first_column_) ||
+                !in.read(loaded.last_column_) || !in.read(loaded.bottom_row_) || !in.read(alive) ||
+                !in.readVector(loaded.invaders_) || !in.readVector(loaded.column_alive_) || !in.readVector(loaded.row_alive_)) {
+                return false;
+            }
+            if (loaded.invaders_.size() != static_cast<size_t>(loaded.rows_) * static_cast<size_t>(loaded.cols_) ||
+                loaded.column_alive_.size() != static_cast<size_t>(loaded.cols_) ||
+                loaded.row_alive_.size() != static_cast<size_t>(loaded.rows_)) {
+                return false;
+            }
+
+            loaded.alive_ = static_cast<size_t>(alive);
+            *this = std::move(loaded);
+            return true;
+        }
+
+        [[nodiscard]] const std::vector<Invader> &invaders() const noexcept { return invaders_; }
+        [[nodiscard]] core::Vector2 origin() const noexcept { return origin_; }
+        [[nodiscard]] core::Vector2 invaderSize() const noexcept { return size_; }
+        [[nodiscard]] size_t aliveCount() const noexcept { return alive_; }
+    };
+
+    struct BulletContact {
+        core::ecs::Entity bullet{};
+        size_t invader{};
+        float time{};
+        // Position in the tick's contact list, which breaks ties in time.
+        uint32_t order{};
     };
 
     class SpaceInvadersGame final : public Game {
-        std::unique_ptr<Player> player_;
-        std::vector<std::unique_ptr<Invader> > invaders_;
-        std::vector<std::unique_ptr<Bullet> > bullets_;
+        core::ecs::World world_;
+        core::ecs::Scheduler scheduler_;
+        core::ThreadPool &pool_{core::ThreadPool::shared()};
+        core::audio::AudioSystem &audio_{core::audio::AudioSystem::shared()};
+        core::ecs::Entity player_{};
+        Settings settings_;
+        InvaderFormation formation_;
+        std::vector<core::SweepHit> sweep_hits_;
+        std::vector<BulletContact> contacts_;
+        core::ParticleSystem particles_{MAX_PARTICLES};
+        core::Random random_;
+        float auto_fire_accumulator_{0.0f};
+        uint32_t shots_fired_{0};
+        // Every shot fired, hit and bullet gone off screen, for hashState; a stress wave
+        // has too many bullets to walk each tick.
+        uint64_t digest_{0};
+        // Set by the collide system, which may run on a pool thread; sounds are posted
+        // from update() once the scheduler has finished.
+        uint32_t kills_this_tick_{0};
+        float last_kill_x_{0.0f};
+        bool wave_cleared_{false};
 
         GameState state_{GameState::Playing};
+        float tick_dt_{0.0f};
         float invader_move_timer_{0.0f};
         int invader_direction_{1};
         int score_{0};
 
+        static constexpr float MARCH_STEP = 40.0f;
+        static constexpr float DROP_STEP = 10.0f;
+        static constexpr size_t MAX_BULLETS = 100'000;
+        static constexpr size_t MAX_PARTICLES = 100'000;
+
+        // The normal 5x10 grid keeps its 60x30 spacing; larger grids close up to fit.
         void createInvaders() {
-            invaders_.clear();
-            for (int row = 0; row < 5; ++row) {
-                for (int col = 0; col < 10; ++col) {
-                    auto invader = std::make_unique<Invader>(
-                        core::Vector2{50.0f + static_cast<float>(col) * 60.0f, 600.0f - 100.0f - static_cast<float>(row) * 30.0f}
-                    );
-                    invaders_.push_back(std::move(invader));
-                }
-            }
+            const core::Vector2 spacing{
+                std::min(60.0f, 700.0f / static_cast<float>(std::max(settings_.cols - 1, 1))),
+                std::min(30.0f, 350.0f / static_cast<float>(std::max(settings_.rows - 1, 1)))
+            };
+            formation_.create(settings_.rows, settings_.cols, {50.0f, 600.0f - 100.0f}, spacing);
+        }
+
+        void movePlayer(core::ecs::World &world) const {
+            world.each<core::Transform, const core::Velocity, PlayerShip>(
+                [dt = tick_dt_](core::Transform &transform, const core::Velocity &velocity, PlayerShip &ship) {
+                    transform.pos += velocity.value * dt;
+
+                    // Keep player on screen
+                    transform.pos.x = std::clamp(transform.pos.x, transform.size.x / 2, 800 - transform.size.x / 2);
+
+                    ship.fire_cooldown = std::max(0.0f, ship.fire_cooldown - dt);
+                });
+        }
+
+        // Only moves; leaving the screen is resolved after the swept collision pass so a
+        // bullet that crosses an invader on its way out still hits it.
+        void moveBullets(core::ecs::World &world) const {
+            world.each<core::Transform, const core::Velocity, Projectile>(
+                [dt = tick_dt_](core::Transform &transform, const core::Velocity &velocity, Projectile &projectile) {
+                    projectile.prev_pos = transform.pos;
+                    transform.pos += velocity.value * dt;
+                });
         }
 
-        void updateInvaders(const float dt) {
-            invader_move_timer_ += dt;
+        void updateInvaders() {
+            invader_move_timer_ += tick_dt_;
 
             if (invader_move_timer_ > 1.0f) {
                 invader_move_timer_ = 0.0f;
 
-                for (const auto &invader: invaders_) {
-                    if (invader->active) {
-                        invader->pos.x += invader->velocity.x;
-                    }
-                }
+                formation_.translate({MARCH_STEP * static_cast<float>(invader_direction_), 0.0f});
 
-                bool change_direction = false;
-                for (const auto &invader: invaders_) {
-                    if (invader->active && (invader->pos.x < 20 || invader->pos.x > 780)) {
-                        change_direction = true;
-                        break;
-                    }
-                }
-
-                if (change_direction) {
+                if (formation_.liveLeft() < 20 || formation_.liveRight() > 780) {
                     invader_direction_ *= -1;
-                    for (const auto &invader: invaders_) {
-                        if (invader->active) {
-                            invader->velocity.x = 20.0f * static_cast<float>(invader_direction_);
-                            invader->pos.y -= 10.0f;
-
-                            if (invader->pos.y <= 70.0f) {
-                                state_ = GameState::GameOver;
-                            }
+                    formation_.translate({0.0f, -DROP_STEP});
+
+                    if (formation_.liveBottom() <= 70.0f) {
+                        if (settings_.endless) {
+                            createInvaders();
+                        } else {
+                            state_ = GameState::GameOver;
                         }
                     }
                 }
             }
         }
 
-        void checkCollisions() {
-            for (const auto &bullet: bullets_) {
-                if (!bullet->active || !bullet->is_player_bullet) continue;
-
-                for (auto &invader: invaders_) {
-                    if (!invader->active) continue;
-
-                    if (bullet->collidesWith(*invader)) {
-                        bullet->active = false;
-                        invader->active = false;
-                        score_ += 10;
-                        break;
+        // Bullets are swept from their previous position so low tick rates cannot tunnel
+        // through an invader; contacts from all bullets resolve in time-of-impact order.
+        void checkCollisions(core::ecs::World &world) {
+            contacts_.clear();
+            world.each<const core::Transform, const Projectile>(
+                [this](const core::ecs::Entity entity, const core::Transform &transform, const Projectile &projectile) {
+                    if (!projectile.from_player) return;
+
+                    sweep_hits_.clear();
+                    if (!formation_.sweepTest(core::AABB::fromCenter(projectile.prev_pos, transform.size),
+                                              transform.pos - projectile.prev_pos, sweep_hits_)) {
+                        return;
                     }
-                }
+                    for (const auto &hit: sweep_hits_) {
+                        contacts_.push_back({entity, hit.index, hit.time, static_cast<uint32_t>(contacts_.size())});
+                    }
+                });
+
+            std::ranges::sort(contacts_, [](const BulletContact &a, const BulletContact &b) {
+                return a.time < b.time || (a.time == b.time && a.order < b.order);
+            });
+
+            for (const auto &contact: contacts_) {
+                Projectile &bullet = *world.get<Projectile>(contact.bullet);
+                if (bullet.spent || !formation_.invaders()[contact.invader].active) continue;
+
+                bullet.spent = true;
+                world.destroyLater(contact.bullet);
+                formation_.kill(contact.invader);
+                digest_ += core::StateHash{}.add(contact.invader).add(contact.time).value();
+                const core::Vector2 at = formation_.origin() + formation_.invaders()[contact.invader].offset;
+                particles_.emit(core::particle_presets::EXPLOSION, at);
+                ++kills_this_tick_;
+                last_kill_x_ = at.x;
+                score_ += 10;
             }
 
-            const bool any_active = std::ranges::any_of(invaders_,
-                                                        [](const auto &inv) { return inv->active; });
-            if (!any_active) {
+            world.each<const core::Transform, const Projectile>(
+                [this, &world](const core::ecs::Entity entity, const core::Transform &transform, const Projectile &bullet) {
+                    if (!bullet.spent && (transform.pos.y < 0 || transform.pos.y > 600)) {
+                        world.destroyLater(entity);
+                        digest_ += core::StateHash{}.add(transform.pos).value();
+                    }
+                });
+
+            if (formation_.aliveCount() == 0) {
                 createInvaders();
+                wave_cleared_ = true;
             }
         }
 
-        void cleanupEntities() {
-            std::erase_if(bullets_,
-                          [](const auto &bullet) { return !bullet->active; });
+        void registerSystems() {
+            using core::ecs::Access;
+
+            scheduler_.add("move-player", Access{}.read<core::Velocity>().write<core::Transform, PlayerShip>(),
+                           [this](core::ecs::World &world) { movePlayer(world); });
+            scheduler_.add("march-invaders", Access{}.write<FormationResource>(),
+                           [this](core::ecs::World &) { updateInvaders(); });
+            scheduler_.add("move-bullets", Access{}.read<core::Velocity>().write<core::Transform, Projectile>(),
+                           [this](core::ecs::World &world) { moveBullets(world); });
+            scheduler_.add("collide", Access{}.read<core::Transform>().write<Projectile, FormationResource, ScoreResource, ParticleResource>(),
+                           [this](core::ecs::World &world) {
+                               const core::alloc::Scope alloc_scope{core::alloc::Tag::Collision};
+                               checkCollisions(world);
+                           });
+            scheduler_.add("particles", Access{}.write<ParticleResource>(),
+                           [this](core::ecs::World &) { particles_.update(tick_dt_); });
+        }
 
-            std::erase_if(invaders_,
-                          [](const auto &invader) { return !invader->active; });
+        void fire(const core::Vector2 muzzle) {
+            world_.create(core::Transform{muzzle, Projectile::SIZE},
+                          core::Velocity{{0.0f, settings_.bullet_speed}},
+                          Projectile{muzzle, true, false});
+            ++shots_fired_;
+            digest_ += core::StateHash{}.add(muzzle).add(settings_.bullet_speed).value();
+        }
+
+        // Auto-fire spreads shots over the screen width along a golden-ratio sequence, so
+        // every part of the formation is under fire whatever the rate.
+        void autoFire(const core::Transform &ship) {
+            auto_fire_accumulator_ += tick_dt_ * settings_.auto_fire_rate;
+            size_t live = world_.count<Projectile>();
+            for (; auto_fire_accumulator_ >= 1.0f; auto_fire_accumulator_ -= 1.0f) {
+                if (live >= MAX_BULLETS) continue;
+
+                const double spread = std::fmod(static_cast<double>(shots_fired_) * 0.6180339887, 1.0);
+                fire({10.0f + static_cast<float>(spread) * 780.0f, ship.pos.y + ship.size.y / 2.0f});
+                ++live;
+            }
+        }
+
+        [[nodiscard]] static float panFor(const float x) noexcept {
+            return x / 400.0f - 1.0f;
         }
 
     public:
-        SpaceInvadersGame() {
+        explicit SpaceInvadersGame(const core::Random &random, const Settings &settings = {})
+            : settings_(settings), random_(random) {
+            registerSystems();
             reset();
         }
 
         void update(const float dt, core::InputManager &input) override {
             if (state_ != GameState::Playing) return;
 
-            player_->velocity.x = input.getHorizontalAxis() * 200.0f;
-            player_->update(dt);
-
-            if (input.isShootJustPressed() && player_->canFire()) {
-                auto bullet = std::make_unique<Bullet>(
-                    player_->pos + core::Vector2{0.0f, player_->size.y / 2.0f},
-                    core::Vector2{0.0f, 300.0f}
-                );
-                bullets_.push_back(std::move(bullet));
-                player_->fired();
-            }
-
-            for (const auto &bullet: bullets_) {
-                bullet->update(dt);
+            tick_dt_ = dt;
+            world_.get<core::Velocity>(player_)->value.x = input.getHorizontalAxis() * PlayerShip::SPEED;
+
+            kills_this_tick_ = 0;
+            wave_cleared_ = false;
+            scheduler_.run(world_, pool_);
+
+            // One hit per tick however many died, so a stress wave cannot flood the mixer.
+            if (kills_this_tick_ > 0) audio_.play(core::audio::Sound::Hit, 0.8f, panFor(last_kill_x_));
+            if (wave_cleared_) audio_.play(core::audio::Sound::Score);
+
+            const core::Transform &transform = *world_.get<core::Transform>(player_);
+            if (settings_.auto_fire_rate > 0.0f) {
+                autoFire(transform);
+            } else if (PlayerShip &ship = *world_.get<PlayerShip>(player_);
+                input.isShootJustPressed() && ship.fire_cooldown <= 0.0f) {
+                fire(transform.pos + core::Vector2{0.0f, transform.size.y / 2.0f});
+                ship.fire_cooldown = PlayerShip::FIRE_COOLDOWN;
+                audio_.play(core::audio::Sound::Shot, 0.6f, panFor(transform.pos.x));
             }
-
-            for (const auto &invader: invaders_) {
-                invader->update(dt);
-            }
-
-            updateInvaders(dt);
-            checkCollisions();
-            cleanupEntities();
         }
 
         void render(core::Renderer &renderer) override {
-            core::Renderer::clear(0.0f, 0.0f, 0.1f);
-
-            if (state_ == GameState::Playing) {
-                core::Renderer::setColor(0.0f, 1.0f, 0.0f);
-                core::Renderer::drawRect(player_->pos.x, player_->pos.y, player_->size.x, player_->size.y);
-
-                core::Renderer::setColor(1.0f, 0.0f, 0.0f);
-                for (const auto &invader: invaders_) {
-                    if (invader->active) {
-                        core::Renderer::drawRect(invader->pos.x, invader->pos.y, invader->size.x, invader->size.y);
+            renderer.clear(0.0f, 0.0f, 0.1f);
+
+            if (state_ == GameState::Playing || state_ == GameState::Paused) {
+                const core::Transform &player = *world_.get<core::Transform>(player_);
+                renderer.setColor(0.0f, 1.0f, 0.0f);
+                renderer.drawRect(player.pos.x, player.pos.y, player.size.x, player.size.y);
+
+                renderer.setColor(1.0f, 0.0f, 0.0f);
+                renderer.setTranslation(formation_.origin().x, formation_.origin().y);
+                const core::Vector2 invader_size = formation_.invaderSize();
+                for (const auto &invader: formation_.invaders()) {
+                    if (invader.active) {
+                        renderer.drawRect(invader.offset.x, invader.offset.y, invader_size.x, invader_size.y);
                     }
                 }
+                renderer.setTranslation(0.0f, 0.0f);
 
-                core::Renderer::setColor(1.0f, 1.0f, 1.0f);
-                for (const auto &bullet: bullets_) {
-                    if (bullet->active) {
-                        core::Renderer::drawRect(bullet->pos.x, bullet->pos.y, bullet->size.x, bullet->size.y);
-                    }
-                }
+                particles_.fill(renderer.drawQuads(particles_.size()));
 
-                renderer.drawText("SCORE: " + std::to_string(score_),
+                renderer.setColor(1.0f, 1.0f, 1.0f);
+                world_.each<const core::Transform, const Projectile>(
+                    [&renderer](const core::Transform &bullet, const Projectile &) {
+                        renderer.drawRect(bullet.pos.x, bullet.pos.y, bullet.size.x, bullet.size.y);
+                    });
+
+                renderer.drawText(renderer.frameArena().concat("SCORE: ", score_),
                                   20.0f, 580.0f, 1.2f,
                                   core::Color{1.0f, 1.0f, 0.0f});
+
+                if (settings_.auto_fire_rate > 0.0f) {
+                    renderer.setLayer(core::RenderLayer::Overlay);
+                    renderer.drawText(renderer.frameArena().concat("INVADERS: ", formation_.aliveCount(),
+                                                                   "  BULLETS: ", world_.count<Projectile>()),
+                                      20.0f, 555.0f, 1.0f,
+                                      core::Color{0.7f, 1.0f, 0.7f});
+                }
             } else if (state_ == GameState::GameOver) {
-                core::Renderer::setColor(0.0f, 0.0f, 0.0f, 0.7f);
-                core::Renderer::drawRect(400.0f, 300.0f, 600.0f, 200.0f);
+                renderer.setLayer(core::RenderLayer::Overlay);
+                renderer.setColor(0.0f, 0.0f, 0.0f, 0.7f);
+                renderer.drawRect(400.0f, 300.0f, 600.0f, 200.0f);
 
                 renderer.drawTextCentered("GAME OVER",
                                           400.0f, 350.0f, 2.5f,
                                           core::Color{1.0f, 0.2f, 0.2f});
-                renderer.drawTextCentered("Final Score: " + std::to_string(score_),
+                renderer.drawTextCentered(renderer.frameArena().concat("Final Score: ", score_),
                                           400.0f, 310.0f, 1.5f,
                                           core::Color{1.0f, 1.0f, 1.0f});
                 renderer.drawTextCentered("Press ESC to return to menu",
@@ -246,19 +524,180 @@ namespace games::space_invaders {
             return state_;
         }
 
+        void setPaused(const bool paused) override {
+            if (paused && state_ == GameState::Playing) {
+                state_ = GameState::Paused;
+            } else if (!paused && state_ == GameState::Paused) {
+                state_ = GameState::Playing;
+            }
+        }
+
         void reset() override {
             state_ = GameState::Playing;
             score_ = 0;
             invader_move_timer_ = 0.0f;
             invader_direction_ = 1;
-
-            player_ = std::make_unique<Player>(800.0f);
-            bullets_.clear();
+            auto_fire_accumulator_ = 0.0f;
+            shots_fired_ = 0;
+            digest_ = 0;
+            particles_.clear();
+            particles_.reseed(random_.split());
+
+            world_.clear();
+            player_ = world_.create(core::Transform{{400.0f, 50.0f}, PlayerShip::SIZE},
+                                    core::Velocity{},
+                                    PlayerShip{});
             createInvaders();
         }
 
+        void reseed(const core::Random &random) override {
+            random_ = random;
+        }
+
         [[nodiscard]] const char *getName() const override {
             return "Space Invaders";
         }
+
+        [[nodiscard]] std::unique_ptr<core::InputSource> createAutopilot() const override;
+
+        // Bullets are saved in iteration order and recreated in it, so contacts that tie
+        // on time of impact still resolve in the same order after a load.
+        [[nodiscard]] bool saveState(core::StateWriter &out) const override {
+            out.write(settings_);
+            out.write(state_);
+            out.write(score_);
+            out.write(invader_move_timer_);
+            out.write(invader_direction_);
+            out.write(auto_fire_accumulator_);
+            out.write(shots_fired_);
+            out.write(digest_);
+            out.write(random_);
+            formation_.save(out);
+
+            out.write(player());
+            out.write(*world_.get<core::Velocity>(player_));
+            out.write(ship());
+            out.write(static_cast<uint64_t>(world_.count<Projectile>()));
+            world_.each<const core::Transform, const core::Velocity, const Projectile>(
+                [&out](const core::Transform &transform, const core::Velocity &velocity, const Projectile &projectile) {
+                    out.write(transform);
+                    out.write(velocity);
+                    out.write(projectile);
+                });
+            return true;
+        }
+
+        [[nodiscard]] bool loadState(core::StateReader &in) override {
+            Settings settings;
+            GameState state{};
+            int score = 0, direction = 1;
+            float move_timer = 0.0f, fire_accumulator = 0.0f;
+            uint32_t shots = 0;
+            uint64_t digest = 0;
+            core::Random random;
+            InvaderFormation formation;
+            core::Transform transform;
+            core::Velocity velocity;
+            PlayerShip ship;
+            uint64_t bullets = 0;
+            if (!in.read(settings) || !in.read(state) || !in.read(score) || !in.read(move_timer) || !in.read(direction) ||
+                !in.read(fire_accumulator) || !in.read(shots) || !in.read(digest) || !in.read(random) || !formation.load(in) ||
+                !in.read(transform) || !in.read(velocity) || !in.read(ship) || !in.read(bullets)) {
+                return false;
+            }
+
+            std::vector<std::tuple<core::Transform, core::Velocity, Projectile> > projectiles(
+                std::min<uint64_t>(bullets, MAX_BULLETS + 1));
+            for (auto &[bullet_transform, bullet_velocity, projectile]: projectiles) {
+                if (!in.read(bullet_transform) || !in.read(bullet_velocity) || !in.read(projectile)) return false;
+            }
+            if (projectiles.size() != bullets || !in.finished()) return false;
+
+            settings_ = settings;
+            state_ = state;
+            score_ = score;
+            invader_move_timer_ = move_timer;
+            invader_direction_ = direction;
+            auto_fire_accumulator_ = fire_accumulator;
+            shots_fired_ = shots;
+            digest_ = digest;
+            random_ = random;
+            formation_ = std::move(formation);
+            particles_.clear();
+
+            world_.clear();
+            player_ = world_.create(transform, velocity, ship);
+            for (const auto &[bullet_transform, bullet_velocity, projectile]: projectiles) {
+                world_.create(bullet_transform, bullet_velocity, projectile);
+            }
+            return true;
+        }
+
+        void hashState(core::StateHash &hash) const override {
+            hash.add(state_).add(score_).add(random_).add(digest_).add(shots_fired_);
+            hash.add(invader_move_timer_).add(invader_direction_).add(auto_fire_accumulator_);
+            hash.add(formation_.origin()).add(formation_.aliveCount());
+            hash.add(player().pos).add(ship().fire_cooldown).add(world_.count<Projectile>());
+        }
+
+        // How far the formation will have marched after the given time, bouncing off the
+        // edges as updateInvaders() does; kills in the meantime are not foreseen.
+        [[nodiscard]] core::Vector2 marchAfter(float seconds) const noexcept {
+            core::Vector2 shift{};
+            float timer = invader_move_timer_;
+            int direction = invader_direction_;
+            while (seconds > 1.0f - timer) {
+                seconds -= 1.0f - timer;
+                timer = 0.0f;
+                shift.x += MARCH_STEP * static_cast<float>(direction);
+                if (formation_.liveLeft() + shift.x < 20 || formation_.liveRight() + shift.x > 780) {
+                    direction *= -1;
+                    shift.y -= DROP_STEP;
+                }
+            }
+            return shift;
+        }
+
+        [[nodiscard]] const InvaderFormation &formation() const noexcept { return formation_; }
+        [[nodiscard]] const core::Transform &player() const noexcept { return *world_.get<core::Transform>(player_); }
+        [[nodiscard]] const PlayerShip &ship() const noexcept { return *world_.get<PlayerShip>(player_); }
+        [[nodiscard]] const Settings &settings() const noexcept { return settings_; }
+    };
+
+    // Hunts the lowest invaders: steers under the one nearest the ship, leading it by the
+    // march the formation makes while a shot climbs, and fires whenever lined up.
+    class Autopilot final : public core::InputSource {
+        const SpaceInvadersGame &game_;
+        bool fired_{false};
+
+        // Distance over which the ship eases off so it settles under the target.
+        static constexpr float SLOWDOWN = 10.0f;
+
+    public:
+        explicit Autopilot(const SpaceInvadersGame &game) : game_(game) {
+        }
+
+        void sample(core::InputState &state) override {
+            state.horizontal = 0.0f;
+            state.shoot = false;
+            if (game_.getState() != GameState::Playing) return;
+
+            const core::Transform &player = game_.player();
+            const std::optional<core::Vector2> target = game_.formation().lowestNear(player.pos.x);
+            if (!target) return;
+
+            const float muzzle_y = player.pos.y + player.size.y / 2.0f;
+            const float flight = (target->y - muzzle_y) / game_.settings().bullet_speed;
+            const float dx = target->x + game_.marchAfter(flight).x - player.pos.x;
+            state.horizontal = std::clamp(dx / SLOWDOWN, -1.0f, 1.0f);
+
+            // Shots are edge-triggered, so the button is released between them.
+            const bool lined_up = std::abs(dx) <= game_.formation().invaderSize().x / 2.0f;
+            state.shoot = fired_ = !fired_ && lined_up && game_.ship().fire_cooldown <= 0.0f;
+        }
     };
+
+    inline std::unique_ptr<core::InputSource> SpaceInvadersGame::createAutopilot() const {
+        return std::make_unique<Autopilot>(*this);
+    }
 }
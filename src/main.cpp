@@ -2,19 +2,117 @@
 #include <iostream>
 #include <memory>
 #include <vector>
+#include <string>
+#include <string_view>
+#include <stdexcept>
 #include <cmath>
+#include <future>
+#include <iomanip>
+#include <filesystem>
+#include <limits>
+#include <cctype>
+#include <random>
 
 #include "core/renderer.hpp"
 #include "core/input.hpp"
 #include "core/game.hpp"
+#include "core/game_registry.hpp"
+#include "core/startup_profile.hpp"
+#include "core/thread_pool.hpp"
+#include "core/alloc_tracker.hpp"
+#include "core/metrics_page.hpp"
+#include "core/audio.hpp"
+#include "core/replay.hpp"
+#include "core/state_hash.hpp"
+#ifdef TRACK_ALLOCATIONS
+#include "core/alloc_hooks.hpp"
+#endif
 #include "menu/main_menu.hpp"
 #include "games/space_invaders/space_invaders.hpp"
 #include "games/flappy_bird/flappy_bird.hpp"
+#include "games/flappy_bird/population.hpp"
 
 constexpr int WINDOW_WIDTH = 800;
 constexpr int WINDOW_HEIGHT = 600;
 constexpr int TARGET_FPS = 180;
 constexpr float TARGET_FRAME_TIME = 1000.0f / TARGET_FPS;
+constexpr float MAX_FRAME_CATCH_UP = 0.25f;
+// Runs faster than real time simulate for at most this long per frame before drawing it.
+constexpr double SIM_FRAME_BUDGET_MS = 50.0;
+// Tick rate used when --sim-speed is given without --tick-rate.
+constexpr float DEFAULT_SIM_TICK_RATE = 120.0f;
+// Replay viewer: Left/Right scrub this many times real speed, F fast-forwards.
+constexpr float REPLAY_SCRUB_SPEED = 10.0f;
+constexpr float REPLAY_FAST_FORWARD = 8.0f;
+// While idle the loop still wakes this often so timers such as game unloading advance.
+constexpr int IDLE_WAKE_MS = 250;
+// Every text scale the menu and games draw with; their fonts are opened during startup.
+// Keep in sync with RETRO_GAMES_BAKED_FONT_SIZES in CMakeLists.txt.
+constexpr float UI_TEXT_SCALES[] = {1.0f, 1.2f, 1.5f, 1.8f, 2.0f, 2.5f};
+
+struct LaunchOptions {
+    core::RenderBackendKind backend{core::RenderBackendKind::OpenGL};
+    std::string dump_directory;
+    Uint32 max_frames{0};
+    bool uncapped{false};
+    float tick_rate{0.0f};
+    float game_idle_timeout{30.0f};
+    bool startup_profile{false};
+    bool idle_throttle{true};
+    bool alloc_overlay{false};
+    bool metrics_page{false};
+    bool frame_costs{false};
+    bool audio{true};
+    bool audio_stats{false};
+    // Looped while in the menu and in a game; empty falls back to music/menu.wav and
+    // music/game.wav next to the executable, when present.
+    std::string menu_music;
+    std::string game_music;
+    bool start_stress{false};
+    games::space_invaders::Settings stress{games::space_invaders::Settings::stress()};
+    size_t population{games::flappy_bird::PopulationGame::DEFAULT_BIRDS};
+    // Game started at launch with its autopilot at the controls, by catalog name in lower
+    // case with dashes for spaces. Games later started from the menu are autoplayed too.
+    std::string autoplay;
+    // Simulated seconds per wall-clock second; 0 steps as fast as the machine allows.
+    float sim_speed{1.0f};
+    // Every game draws from its own stream of this, so a seed repeats a session.
+    uint64_t seed{0};
+    // Replay file the last game played is recorded to, and the ticks between its keyframes.
+    std::string record;
+    uint32_t keyframe_interval{core::replay::DEFAULT_KEYFRAME_INTERVAL};
+    // Replay file opened in the viewer instead of the menu.
+    std::string replay;
+    // File the per-tick state hashes of the last game played are logged to, for
+    // tools/hash_compare; --max-ticks ends the run after that many game ticks.
+    std::string hash_log;
+    uint64_t max_ticks{0};
+};
+
+// Simulation and render time per frame, averaged and printed once a second.
+struct FrameCosts {
+    double sim_ms{0.0};
+    double record_ms{0.0};
+    double present_ms{0.0};
+    Uint32 frames{0};
+    double elapsed_ms{0.0};
+
+    static double msSince(const Uint64 start) {
+        return static_cast<double>(SDL_GetPerformanceCounter() - start) * 1000.0 /
+               static_cast<double>(SDL_GetPerformanceFrequency());
+    }
+
+    void print(std::ostream &out) const {
+        const std::ios_base::fmtflags flags = out.flags();
+        const std::streamsize precision = out.precision();
+        const double n = frames;
+        out << std::fixed << std::setprecision(2) << "Frame costs: sim " << sim_ms / n << " ms, render "
+                << (record_ms + present_ms) / n << " ms (record " << record_ms / n << ", submit+present "
+                << present_ms / n << ") over " << frames << " frames\n";
+        out.flags(flags);
+        out.precision(precision);
+    }
+};
 
 enum class AppState {
     Menu,
@@ -24,36 +122,206 @@ enum class AppState {
 
 class GameManager {
 private:
+    LaunchOptions options_;
+    core::StartupProfile startup_;
     std::unique_ptr<core::Renderer> renderer_;
     std::unique_ptr<core::InputManager> input_;
     std::unique_ptr<menu::MainMenu> main_menu_;
-    std::vector<std::unique_ptr<games::Game> > games_;
+    games::GameRegistry games_;
+    core::alloc::Tracker allocations_;
+    FrameCosts costs_;
+    size_t stress_game_index_{0};
+    size_t population_game_index_{0};
+    std::unique_ptr<core::metrics::Publisher> metrics_;
 
     AppState app_state_{AppState::Menu};
+    // State the current music was chosen for.
+    AppState music_state_{AppState::Quitting};
     size_t current_game_index_{0};
     bool running_{true};
     bool escape_was_pressed_{false};
+    bool pause_was_pressed_{false};
+    bool minimized_{false};
+    float tick_accumulator_{0.0f};
+    Uint32 ticks_this_frame_{0};
+    double simulated_seconds_{0.0};
+    Uint32 autoplay_rounds_{0};
+    std::unique_ptr<core::replay::Recorder> recorder_;
+    std::unique_ptr<core::hash_log::Writer> hash_log_;
+    // Ticks the current game has been stepped, counted as recordings count them.
+    uint64_t game_ticks_{0};
+    // Replay viewer; the player steps the game, the cursor is the tick shown, fractional
+    // so slow scrubbing still moves.
+    std::unique_ptr<core::replay::Reader> replay_;
+    std::unique_ptr<core::replay::Player> replay_player_;
+    double replay_cursor_{0.0};
+    bool replay_paused_{false};
+    bool replay_step_was_pressed_{false};
 
     static void initializeSDL() {
-        if (SDL_Init(SDL_INIT_VIDEO | SDL_INIT_GAMECONTROLLER) < 0) {
+        if (SDL_Init(SDL_INIT_VIDEO) < 0) {
             throw std::runtime_error("Failed to initialize SDL: " + std::string(SDL_GetError()));
         }
     }
 
+    static std::unique_ptr<core::InputManager> createInput() {
+        if (SDL_InitSubSystem(SDL_INIT_GAMECONTROLLER) < 0) {
+            throw std::runtime_error("Failed to initialize SDL: " + std::string(SDL_GetError()));
+        }
+        return std::make_unique<core::InputManager>();
+    }
+
     void setupGames() {
-        games_.push_back(std::make_unique<games::space_invaders::SpaceInvadersGame>());
-        games_.push_back(std::make_unique<games::flappy_bird::FlappyBirdGame>());
+        games_.add<games::space_invaders::SpaceInvadersGame>("Space Invaders");
+        games_.add<games::flappy_bird::FlappyBirdGame>("Flappy Bird");
+
+        stress_game_index_ = games_.size();
+        games_.add<games::space_invaders::SpaceInvadersGame>("Space Invaders Stress", options_.stress);
+
+        population_game_index_ = games_.size();
+        games_.add<games::flappy_bird::PopulationGame>("Flappy Bird Population", options_.population);
+    }
+
+    void startGame(const size_t index) {
+        current_game_index_ = index;
+        const games::Game &game = games_.start(current_game_index_);
+        app_state_ = AppState::InGame;
+        game_ticks_ = 0;
+        if (!options_.autoplay.empty()) {
+            input_->setSource(game.createAutopilot());
+        }
+        if (!options_.record.empty()) {
+            startRecording(game);
+        }
+        if (!options_.hash_log.empty()) {
+            hash_log_ = std::make_unique<core::hash_log::Writer>(options_.hash_log, games_.getName(current_game_index_),
+                                                                 options_.seed, options_.tick_rate,
+                                                                 static_cast<uint32_t>(core::detectSimdLevel()));
+        }
+    }
+
+    // Only games that can save their state are recorded; the file keeps the last one.
+    void startRecording(const games::Game &game) {
+        std::vector<uint8_t> probe;
+        core::StateWriter writer{probe};
+        if (!game.saveState(writer)) {
+            std::cerr << game.getName() << " cannot be recorded\n";
+            return;
+        }
+        recorder_ = std::make_unique<core::replay::Recorder>(options_.record, games_.getName(current_game_index_),
+                                                             options_.seed, options_.tick_rate, options_.keyframe_interval);
+    }
+
+    void stopHashLog() {
+        hash_log_->flush();
+        std::cout << "Logged " << hash_log_->ticks() << " state hashes to " << options_.hash_log << "\n";
+        hash_log_.reset();
+    }
+
+    void stopRecording() {
+        recorder_->flush();
+        std::cout << "Recorded " << recorder_->ticks() << " ticks to " << options_.record << "\n";
+        recorder_.reset();
+    }
+
+    void startReplay() {
+        replay_ = std::make_unique<core::replay::Reader>(options_.replay);
+        size_t index = games_.size();
+        for (size_t i = 0; i < games_.size(); ++i) {
+            if (games_.getName(i) == replay_->gameName()) index = i;
+        }
+        if (index == games_.size()) {
+            throw std::runtime_error("Replay is of an unknown game: " + std::string(replay_->gameName()));
+        }
+
+        current_game_index_ = index;
+        replay_player_ = std::make_unique<core::replay::Player>(*replay_, games_.start(index));
+        app_state_ = AppState::InGame;
+        std::cout << "Replaying " << replay_->gameName() << ": " << replay_->ticks() << " ticks at "
+                << replay_->header().tick_rate << " Hz, " << replay_->keyframes().size() << " keyframes, seed "
+                << replay_->header().seed << "\n";
+        std::cout << "  P pause, Left/Right scrub, F fast-forward, Home restart, ,/. step while paused\n";
+    }
+
+    // Moves the replay cursor by this frame's controls and steps or seeks the game to it.
+    // Anything faster than real time is simulated silently.
+    void advanceReplay(const float delta_time) {
+        input_->update();
+        const double rate = replay_player_->tickRate();
+        const double frame_ticks = static_cast<double>(std::min(delta_time, MAX_FRAME_CATCH_UP)) * rate;
+        const auto length = static_cast<double>(replay_player_->ticks());
+
+        double cursor = replay_cursor_;
+        bool real_time = false;
+        if (input_->isKeyPressed(SDL_SCANCODE_HOME)) {
+            cursor = 0.0;
+        } else if (input_->isKeyPressed(SDL_SCANCODE_LEFT)) {
+            cursor -= frame_ticks * REPLAY_SCRUB_SPEED;
+        } else if (input_->isKeyPressed(SDL_SCANCODE_RIGHT)) {
+            cursor += frame_ticks * REPLAY_SCRUB_SPEED;
+        } else if (input_->isKeyPressed(SDL_SCANCODE_F)) {
+            cursor += frame_ticks * REPLAY_FAST_FORWARD;
+        } else if (!replay_paused_) {
+            cursor += frame_ticks;
+            real_time = true;
+        }
+
+        const bool back = input_->isKeyPressed(SDL_SCANCODE_COMMA);
+        const bool forward = input_->isKeyPressed(SDL_SCANCODE_PERIOD);
+        if (replay_paused_ && (back || forward) && !replay_step_was_pressed_) {
+            cursor = std::floor(cursor) + (forward ? 1.0 : -1.0);
+        }
+        replay_step_was_pressed_ = back || forward;
+
+        replay_cursor_ = std::clamp(cursor, 0.0, length);
+        if (replay_cursor_ >= length) replay_paused_ = true;
+
+        core::audio::AudioSystem &audio = core::audio::AudioSystem::shared();
+        audio.setMuted(!real_time);
+        ticks_this_frame_ += static_cast<Uint32>(
+            replay_player_->seek(static_cast<uint64_t>(replay_cursor_), *input_));
+        audio.setMuted(false);
+    }
+
+    void drawReplayTimeline() const {
+        const float length = static_cast<float>(std::max<uint64_t>(replay_player_->ticks(), 1));
+        const float progress = static_cast<float>(replay_player_->tick()) / length;
+
+        renderer_->setLayer(core::RenderLayer::Overlay);
+        renderer_->setColor(0.0f, 0.0f, 0.0f, 0.6f);
+        renderer_->drawRect(400.0f, 14.0f, 760.0f, 8.0f);
+        renderer_->setColor(1.0f, 1.0f, 1.0f, 0.3f);
+        for (const core::replay::Reader::Keyframe &keyframe: replay_->keyframes()) {
+            renderer_->drawRect(20.0f + 760.0f * static_cast<float>(keyframe.tick) / length, 14.0f, 1.0f, 8.0f);
+        }
+        renderer_->setColor(1.0f, 0.8f, 0.2f, 1.0f);
+        renderer_->drawRect(20.0f + 380.0f * progress, 14.0f, 760.0f * progress, 8.0f);
+
+        const double rate = replay_player_->tickRate();
+        core::FrameArena &arena = renderer_->frameArena();
+        renderer_->drawText(arena.concat(replay_paused_ ? "REPLAY PAUSED " : "REPLAY ",
+                                         static_cast<int>(static_cast<double>(replay_player_->tick()) / rate), " / ",
+                                         static_cast<int>(static_cast<double>(replay_player_->ticks()) / rate), " s"),
+                            20.0f, 36.0f, 1.0f, core::Color{1.0f, 1.0f, 1.0f});
+    }
+
+    // "Space Invaders Stress" is picked with --autoplay space-invaders-stress.
+    [[nodiscard]] size_t findGame(const std::string_view key) const {
+        for (size_t i = 0; i < games_.size(); ++i) {
+            std::string name = games_.getName(i);
+            for (char &c: name) {
+                c = c == ' ' ? '-' : static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+            }
+            if (name == key) return i;
+        }
+        throw std::runtime_error("Unknown game for --autoplay: " + std::string(key));
     }
 
     void setupMenu() {
         main_menu_ = std::make_unique<menu::MainMenu>();
 
         for (size_t i = 0; i < games_.size(); ++i) {
-            main_menu_->addItem(games_[i]->getName(), [this, i]() {
-                current_game_index_ = i;
-                games_[current_game_index_]->reset();
-                app_state_ = AppState::InGame;
-            });
+            main_menu_->addItem(games_.getName(i), [this, i]() { startGame(i); });
         }
 
         main_menu_->addItem("Quit", [this]() {
@@ -61,15 +329,103 @@ private:
         });
     }
 
-    void handleEvents() {
+    static std::string bundledMusic(const char *name) {
+        char *base = SDL_GetBasePath();
+        if (!base) return {};
+        const std::filesystem::path path = std::filesystem::path(base) / "music" / name;
+        SDL_free(base);
+        std::error_code error;
+        return std::filesystem::exists(path, error) ? path.string() : std::string{};
+    }
+
+    // Crossfades when the app moves between the menu and a game.
+    void updateMusic() {
+        if (app_state_ == music_state_) return;
+        music_state_ = app_state_;
+
+        switch (app_state_) {
+            case AppState::Menu:
+                core::audio::AudioSystem::shared().playMusic(options_.menu_music);
+                break;
+            case AppState::InGame:
+                core::audio::AudioSystem::shared().playMusic(options_.game_music);
+                break;
+            case AppState::Quitting:
+                core::audio::AudioSystem::shared().playMusic({});
+                break;
+        }
+    }
+
+    [[nodiscard]] games::Game *activeGame() const noexcept {
+        return app_state_ == AppState::InGame ? games_.get(current_game_index_) : nullptr;
+    }
+
+    [[nodiscard]] bool isPaused() const noexcept {
+        const games::Game *game = activeGame();
+        return game && game->getState() == games::GameState::Paused;
+    }
+
+    // Nothing on screen moves in the menu, in a paused game or while minimized, so the
+    // loop only wakes for events (and the occasional timer tick) instead of rendering.
+    [[nodiscard]] bool isIdle() const noexcept {
+        if (!options_.idle_throttle) return false;
+        // An autoplayed game keeps simulating while minimized; it only stops drawing.
+        if (input_->hasSource() && app_state_ == AppState::InGame && !isPaused()) return false;
+        return minimized_ || app_state_ == AppState::Menu || isPaused();
+    }
+
+    void handleEvent(const SDL_Event &event) {
+        if (event.type == SDL_QUIT) {
+            app_state_ = AppState::Quitting;
+        } else if (event.type == SDL_WINDOWEVENT) {
+            switch (event.window.event) {
+                case SDL_WINDOWEVENT_MINIMIZED:
+                case SDL_WINDOWEVENT_HIDDEN:
+                    minimized_ = true;
+                    [[fallthrough]];
+                case SDL_WINDOWEVENT_FOCUS_LOST:
+                    if (games::Game *game = activeGame(); game && !input_->hasSource() && !replay_player_) {
+                        game->setPaused(true);
+                    }
+                    break;
+                case SDL_WINDOWEVENT_RESTORED:
+                case SDL_WINDOWEVENT_SHOWN:
+                case SDL_WINDOWEVENT_EXPOSED:
+                    minimized_ = false;
+                    break;
+                default:
+                    break;
+            }
+        }
+    }
+
+    // Blocks for up to wait_ms for the first event when wait_ms > 0. Returns whether any
+    // event arrived.
+    bool handleEvents(const int wait_ms) {
+        const core::alloc::Scope alloc_scope{core::alloc::Tag::Input};
+        bool any_event = false;
         SDL_Event event;
+        if (wait_ms > 0 && SDL_WaitEventTimeout(&event, wait_ms)) {
+            handleEvent(event);
+            any_event = true;
+        }
         while (SDL_PollEvent(&event)) {
-            if (event.type == SDL_QUIT) {
-                app_state_ = AppState::Quitting;
-            }
+            handleEvent(event);
+            any_event = true;
         }
 
-        input_->update();
+        if (input_->isPausePressed()) {
+            if (!pause_was_pressed_) {
+                if (replay_player_) {
+                    replay_paused_ = !replay_paused_;
+                } else if (games::Game *game = activeGame()) {
+                    game->setPaused(game->getState() != games::GameState::Paused);
+                }
+                pause_was_pressed_ = true;
+            }
+        } else {
+            pause_was_pressed_ = false;
+        }
 
         if (input_->isEscapePressed()) {
             if (!escape_was_pressed_) {
@@ -83,6 +439,18 @@ private:
         } else {
             escape_was_pressed_ = false;
         }
+
+        // An autopilot reads its game, so it goes before the game can be unloaded.
+        if (app_state_ != AppState::InGame && input_->hasSource()) {
+            input_->setSource(nullptr);
+        }
+        if (app_state_ != AppState::InGame) {
+            if (recorder_) stopRecording();
+            if (hash_log_) stopHashLog();
+            replay_player_.reset();
+            replay_.reset();
+        }
+        return any_event;
     }
 
     void update(const float dt) {
@@ -92,10 +460,33 @@ private:
                 break;
 
             case AppState::InGame:
-                if (current_game_index_ < games_.size()) {
-                    games_[current_game_index_]->update(dt, *input_);
+                // The replay viewer steps its game itself, in advanceReplay.
+                if (replay_player_) break;
+                if (games::Game *game = games_.get(current_game_index_)) {
+                    if (game->getState() == games::GameState::Playing) simulated_seconds_ += dt;
+                    // A paused game does not move, so its ticks are left out of recordings
+                    // and hash logs.
+                    const bool ticking = dt > 0.0f && game->getState() != games::GameState::Paused;
+                    if (recorder_ && ticking) {
+                        recorder_->tick(*game, *input_);
+                    }
+                    game->update(dt, *input_);
 
-                    if (games_[current_game_index_]->getState() == games::GameState::GameOver) {
+                    // Soak runs go on unattended, so a finished round starts the next.
+                    if (input_->hasSource() && game->getState() == games::GameState::GameOver) {
+                        game->reset();
+                        ++autoplay_rounds_;
+                        if (recorder_) recorder_->reset();
+                    }
+
+                    if (!ticking) break;
+                    if (hash_log_) {
+                        core::StateHash hash;
+                        game->hashState(hash);
+                        hash_log_->append(hash.value());
+                    }
+                    if (++game_ticks_ == options_.max_ticks) {
+                        app_state_ = AppState::Quitting;
                     }
                 }
                 break;
@@ -106,15 +497,50 @@ private:
         }
     }
 
-    void render() const {
+    // Last frame's heap allocations per tag, top right (--alloc-overlay).
+    void drawAllocationOverlay() const {
+        renderer_->setLayer(core::RenderLayer::Overlay);
+        renderer_->setColor(0.0f, 0.0f, 0.0f, 0.6f);
+        renderer_->drawRect(700.0f, 520.0f, 190.0f, 150.0f);
+
+        core::FrameArena &arena = renderer_->frameArena();
+        float y = 580.0f;
+        for (size_t tag = 0; tag < core::alloc::TAG_COUNT; ++tag) {
+            const core::alloc::Counts &counts = allocations_.lastFrame()[tag];
+            renderer_->drawText(arena.concat(core::alloc::toString(static_cast<core::alloc::Tag>(tag)), ": ",
+                                             counts.allocations, " / ", counts.bytes, " B"),
+                                612.0f, y, 1.0f,
+                                counts.allocations > 0 ? core::Color{1.0f, 0.4f, 0.4f} : core::Color{0.7f, 1.0f, 0.7f});
+            y -= 22.0f;
+        }
+    }
+
+    [[nodiscard]] bool reportingCosts() const noexcept {
+        return options_.frame_costs || (app_state_ == AppState::InGame && (current_game_index_ == stress_game_index_ ||
+                                                                            current_game_index_ == population_game_index_));
+    }
+
+    void render() {
+        const core::alloc::Scope alloc_scope{core::alloc::Tag::Render};
+        const Uint64 record_start = SDL_GetPerformanceCounter();
+
         switch (app_state_) {
             case AppState::Menu:
                 main_menu_->render(*renderer_);
                 break;
 
             case AppState::InGame:
-                if (current_game_index_ < games_.size()) {
-                    games_[current_game_index_]->render(*renderer_);
+                if (games::Game *game = games_.get(current_game_index_)) {
+                    game->render(*renderer_);
+
+                    if (game->getState() == games::GameState::Paused) {
+                        renderer_->setLayer(core::RenderLayer::Overlay);
+                        renderer_->drawTextCentered("PAUSED",
+                                                    static_cast<float>(WINDOW_WIDTH) / 2.0f,
+                                                    static_cast<float>(WINDOW_HEIGHT) / 2.0f, 2.5f,
+                                                    core::Color{1.0f, 1.0f, 1.0f});
+                    }
+                    if (replay_player_) drawReplayTimeline();
                 }
                 break;
 
@@ -122,21 +548,90 @@ private:
                 break;
         }
 
+        if (core::alloc::TRACKING && options_.alloc_overlay) {
+            drawAllocationOverlay();
+        }
+
+        const Uint64 present_start = SDL_GetPerformanceCounter();
         renderer_->present();
+
+        costs_.record_ms += static_cast<double>(present_start - record_start) * 1000.0 /
+                static_cast<double>(SDL_GetPerformanceFrequency());
+        costs_.present_ms += FrameCosts::msSince(present_start);
     }
 
 public:
-    GameManager() {
-        initializeSDL();
+    // SDL_InitSubSystem is not thread-safe, so the window, controllers and audio device come up
+    // on the main thread; fonts and the game catalog load alongside them and are joined before
+    // the first frame.
+    explicit GameManager(LaunchOptions options)
+        : options_(std::move(options)), games_(options_.game_idle_timeout, options_.seed) {
+        {
+            core::StartupProfile::Scope stage(startup_, "sdl-init", "main");
+            initializeSDL();
+        }
+
+        // The baked font needs no loading at all.
+        std::future<std::unique_ptr<core::FontManager> > fonts;
+        if (!core::BAKED_FONT_AVAILABLE) {
+            fonts = std::async(std::launch::async, [this] {
+                core::StartupProfile::Scope stage(startup_, "fonts", "worker");
+                auto font_manager = std::make_unique<core::FontManager>();
+                font_manager->preload(UI_TEXT_SCALES);
+                return font_manager;
+            });
+        }
+        auto catalog = std::async(std::launch::async, [this] {
+            core::StartupProfile::Scope stage(startup_, "games", "worker");
+            setupGames();
+            setupMenu();
+            core::ThreadPool::shared();
+        });
+        {
+            core::StartupProfile::Scope stage(startup_, "window", "main");
+            renderer_ = std::make_unique<core::Renderer>("Retro Games Collection",
+                                                         WINDOW_WIDTH, WINDOW_HEIGHT, options_.backend);
+            if (!options_.dump_directory.empty()) {
+                renderer_->setFrameDumpDirectory(options_.dump_directory);
+            }
+        }
 
-        renderer_ = std::make_unique<core::Renderer>("Retro Games Collection",
-                                                     WINDOW_WIDTH, WINDOW_HEIGHT);
-        input_ = std::make_unique<core::InputManager>();
+        {
+            core::StartupProfile::Scope stage(startup_, "controllers", "main");
+            input_ = createInput();
+        }
 
-        setupGames();
-        setupMenu();
+        // After the controllers, so the subsystem inits never overlap; the fonts and catalog
+        // workers still hide the time a slow sound server takes to open a device.
+        if (options_.audio) {
+            core::StartupProfile::Scope stage(startup_, "audio", "main");
+            if (options_.menu_music.empty()) options_.menu_music = bundledMusic("menu.wav");
+            if (options_.game_music.empty()) options_.game_music = bundledMusic("game.wav");
+            core::audio::AudioSystem::shared().open();
+        }
+
+        if (options_.metrics_page) {
+            metrics_ = std::make_unique<core::metrics::Publisher>(core::metrics::defaultPageName());
+            std::cout << "Publishing live metrics at " << metrics_->name() << "\n";
+        }
+
+        {
+            core::StartupProfile::Scope stage(startup_, "join", "main");
+            if (fonts.valid()) {
+                renderer_->setFontManager(fonts.get());
+            }
+            catalog.get();
+            if (!options_.replay.empty()) {
+                startReplay();
+            } else if (!options_.autoplay.empty()) {
+                startGame(findGame(options_.autoplay));
+            } else if (options_.start_stress) {
+                startGame(stress_game_index_);
+            }
+        }
 
         std::cout << "Retro Games Collection initialized!\n";
+        std::cout << "Random seed: " << options_.seed << " (repeat with --seed " << options_.seed << ")\n";
         std::cout << "Controls:\n";
         std::cout << "  Menu: Arrow keys or D-pad to navigate, Space/Enter/A button to select\n";
         std::cout << "  Games: Arrow keys or left stick to move, Space/A button to shoot/jump\n";
@@ -148,6 +643,7 @@ public:
     }
 
     ~GameManager() {
+        core::audio::AudioSystem::shared().close();
         SDL_Quit();
     }
 
@@ -155,30 +651,323 @@ public:
 
     GameManager &operator=(const GameManager &) = delete;
 
+    // With --tick-rate the simulation advances in fixed steps, decoupled from the frame
+    // rate; input is sampled once per tick so edge-triggered presses fire exactly once.
+    // --sim-speed scales the time fed to the steps; faster-than-real-time runs give each
+    // frame a fixed budget of simulation and drop whatever does not fit.
+    void tick(const float delta_time) {
+        const core::alloc::Scope alloc_scope{core::alloc::Tag::Update};
+        if (replay_player_) {
+            advanceReplay(delta_time);
+            return;
+        }
+        if (options_.tick_rate <= 0.0f) {
+            input_->update();
+            update(std::min(delta_time, 1.0f / 30.0f));
+            ++ticks_this_frame_;
+            return;
+        }
+
+        const float step = 1.0f / options_.tick_rate;
+        if (options_.sim_speed > 0.0f) {
+            tick_accumulator_ += std::min(delta_time, MAX_FRAME_CATCH_UP) * options_.sim_speed;
+        } else {
+            tick_accumulator_ = std::numeric_limits<float>::max();
+        }
+
+        const bool budgeted = options_.sim_speed != 1.0f;
+        const Uint64 deadline = SDL_GetPerformanceCounter() +
+                                static_cast<Uint64>(SIM_FRAME_BUDGET_MS / 1000.0 * static_cast<double>(SDL_GetPerformanceFrequency()));
+        while (tick_accumulator_ >= step) {
+            input_->update();
+            update(step);
+            tick_accumulator_ -= step;
+            ++ticks_this_frame_;
+
+            if (budgeted && (!activeGame() || isPaused() || SDL_GetPerformanceCounter() >= deadline)) {
+                tick_accumulator_ = 0.0f;
+                break;
+            }
+        }
+    }
+
+    void publishMetrics(const Uint64 frame_counter_delta) {
+        uint64_t allocations = 0;
+        for (const core::alloc::Counts &counts: allocations_.lastFrame()) {
+            allocations += counts.allocations;
+        }
+
+        const bool in_game = app_state_ == AppState::InGame;
+        metrics_->setGame(in_game ? std::string_view{games_.getName(current_game_index_)} : std::string_view{});
+        const core::audio::Stats audio = core::audio::AudioSystem::shared().stats();
+        metrics_->publish({
+            static_cast<uint32_t>(app_state_),
+            in_game ? static_cast<uint32_t>(current_game_index_) : UINT32_MAX,
+            static_cast<uint32_t>(frame_counter_delta * 1'000'000 / SDL_GetPerformanceFrequency()),
+            ticks_this_frame_,
+            static_cast<uint32_t>(renderer_->getDrawCallCount()),
+            allocations,
+            audio.underruns,
+            audio.max_latency_us
+        });
+    }
+
+    static void waitForNextFrame(const Uint32 frame_start) {
+        if (const Uint32 frame_time = SDL_GetTicks() - frame_start; static_cast<float>(frame_time) < TARGET_FRAME_TIME) {
+            SDL_Delay(static_cast<Uint32>(TARGET_FRAME_TIME - static_cast<float>(frame_time)));
+        }
+    }
+
     void run() {
         Uint32 last_time = SDL_GetTicks();
+        const Uint64 run_start = SDL_GetPerformanceCounter();
+        Uint64 last_frame_end = run_start;
+        Uint64 state_calls_issued = 0, state_calls_skipped = 0;
+        Uint32 iterations = 0;
+        allocations_.discard();
 
         while (running_) {
+            const core::FrameArena::Scope frame_scope{renderer_->frameArena()};
             const Uint32 current_time = SDL_GetTicks();
-            float delta_time = static_cast<float>(current_time - last_time) / 1000.0f;
+            const float delta_time = static_cast<float>(current_time - last_time) / 1000.0f;
             last_time = current_time;
 
-            delta_time = std::min(delta_time, 1.0f / 30.0f);
+            const bool idle = isIdle();
+            const bool any_event = handleEvents(idle ? IDLE_WAKE_MS : 0);
+            games_.collectIdle(delta_time, app_state_ == AppState::InGame ? current_game_index_ : games_.size());
+
+            // Idle screens have no simulation to step, only input to react to.
+            const Uint64 sim_start = SDL_GetPerformanceCounter();
+            if (idle) {
+                const core::alloc::Scope alloc_scope{core::alloc::Tag::Update};
+                input_->update();
+                update(0.0f);
+                tick_accumulator_ = 0.0f;
+            } else {
+                tick(delta_time);
+            }
+            updateMusic();
+            const double sim_ms = FrameCosts::msSince(sim_start);
+
+            // Counted per pass rather than per presented frame, so a run ends while minimized.
+            if (options_.max_frames > 0 && ++iterations >= options_.max_frames) {
+                running_ = false;
+            }
 
-            handleEvents();
-            update(delta_time);
+            // An idle frame is only redrawn when an event may have changed it; a minimized
+            // window is never drawn, but one still simulating keeps to the frame rate.
+            const bool unchanged = idle && !any_event && isIdle() && renderer_->getFrameIndex() > 0;
+            if (minimized_ && !idle) {
+                waitForNextFrame(current_time);
+                continue;
+            }
+            if (minimized_ || unchanged) continue;
             render();
+            allocations_.endFrame();
+
+            costs_.sim_ms += sim_ms;
+            ++costs_.frames;
+            costs_.elapsed_ms += delta_time * 1000.0f;
+            if (costs_.elapsed_ms >= 1000.0) {
+                if (reportingCosts()) costs_.print(std::cout);
+                costs_ = {};
+            }
+
+            if (metrics_) {
+                const Uint64 frame_end = SDL_GetPerformanceCounter();
+                publishMetrics(frame_end - last_frame_end);
+                last_frame_end = frame_end;
+            }
+            ticks_this_frame_ = 0;
+
+            const core::StateCallStats state_calls = renderer_->getStateCallStats();
+            state_calls_issued += state_calls.issued;
+            state_calls_skipped += state_calls.skipped;
+
+            if (renderer_->getFrameIndex() == 1) {
+                startup_.mark("first-frame", "main");
+                if (options_.startup_profile) {
+                    startup_.print(std::cout);
+                }
+            }
+
+            if (options_.uncapped || idle) continue;
+            waitForNextFrame(current_time);
+        }
 
-            if (const Uint32 frame_time = SDL_GetTicks() - current_time; static_cast<float>(frame_time) < TARGET_FRAME_TIME) {
-                SDL_Delay(static_cast<Uint32>(TARGET_FRAME_TIME - static_cast<float>(frame_time)));
+        const double seconds = static_cast<double>(SDL_GetPerformanceCounter() - run_start) /
+                               static_cast<double>(SDL_GetPerformanceFrequency());
+        if (const Uint32 frames = renderer_->getFrameIndex(); frames > 0 && seconds > 0.0) {
+            std::cout << "Rendered " << frames << " frames with the " << core::toString(renderer_->getBackendKind())
+                    << " renderer in " << seconds << " s (" << static_cast<double>(frames) / seconds << " FPS)\n";
+            if (state_calls_issued + state_calls_skipped > 0) {
+                std::cout << "GL state calls per frame: " << static_cast<double>(state_calls_issued) / frames
+                        << " issued, " << static_cast<double>(state_calls_skipped) / frames << " skipped\n";
             }
         }
+        if (core::alloc::TRACKING) {
+            allocations_.print(std::cout);
+        }
+        if (!options_.autoplay.empty() && seconds > 0.0) {
+            std::cout << "Autoplay: " << simulated_seconds_ << " s of play in " << seconds << " s ("
+                    << simulated_seconds_ / seconds << "x real time), " << autoplay_rounds_ << " rounds finished\n";
+        }
+        if (recorder_) {
+            stopRecording();
+        }
+        if (hash_log_) {
+            stopHashLog();
+        }
+        if (options_.audio_stats && core::audio::AudioSystem::shared().isOpen()) {
+            core::audio::AudioSystem::shared().printStats(std::cout);
+        }
     }
 };
 
-int main([[maybe_unused]] int argc, [[maybe_unused]] char *argv[]) {
+static LaunchOptions parseLaunchOptions(const int argc, char *argv[]) {
+    LaunchOptions options;
+    bool seeded = false;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg = argv[i];
+        const auto value = [&]() -> std::string_view {
+            if (i + 1 >= argc) {
+                throw std::runtime_error("Missing value for " + std::string(arg));
+            }
+            return argv[++i];
+        };
+
+        if (arg == "--renderer") {
+            const std::string_view name = value();
+            if (name == "software") {
+                options.backend = core::RenderBackendKind::Software;
+            } else if (name == "gl") {
+                options.backend = core::RenderBackendKind::OpenGL;
+            } else {
+                throw std::runtime_error("Unknown renderer: " + std::string(name));
+            }
+        } else if (arg == "--dump-frames") {
+            options.dump_directory = value();
+        } else if (arg == "--max-frames") {
+            options.max_frames = static_cast<Uint32>(std::stoul(std::string(value())));
+        } else if (arg == "--tick-rate") {
+            options.tick_rate = std::stof(std::string(value()));
+            if (options.tick_rate <= 0.0f) {
+                throw std::runtime_error("--tick-rate must be positive");
+            }
+        } else if (arg == "--unload-idle-games") {
+            options.game_idle_timeout = std::stof(std::string(value()));
+            if (options.game_idle_timeout < 0.0f) {
+                throw std::runtime_error("--unload-idle-games must not be negative");
+            }
+        } else if (arg == "--startup-profile") {
+            options.startup_profile = true;
+        } else if (arg == "--uncapped") {
+            options.uncapped = true;
+        } else if (arg == "--no-idle") {
+            options.idle_throttle = false;
+        } else if (arg == "--no-audio") {
+            options.audio = false;
+        } else if (arg == "--audio-stats") {
+            options.audio_stats = true;
+        } else if (arg == "--menu-music") {
+            options.menu_music = value();
+        } else if (arg == "--game-music") {
+            options.game_music = value();
+        } else if (arg == "--frame-costs") {
+            options.frame_costs = true;
+        } else if (arg == "--stress") {
+            options.start_stress = true;
+        } else if (arg == "--stress-grid") {
+            const std::string grid{value()};
+            const size_t x = grid.find('x');
+            if (x == std::string::npos) {
+                throw std::runtime_error("--stress-grid expects ROWSxCOLS");
+            }
+            options.stress.rows = std::stoi(grid.substr(0, x));
+            options.stress.cols = std::stoi(grid.substr(x + 1));
+            if (options.stress.rows <= 0 || options.stress.cols <= 0 ||
+                static_cast<long long>(options.stress.rows) * options.stress.cols > 1'000'000) {
+                throw std::runtime_error("--stress-grid must be positive and at most 1000000 invaders");
+            }
+        } else if (arg == "--stress-fire-rate") {
+            options.stress.auto_fire_rate = std::stof(std::string(value()));
+            if (options.stress.auto_fire_rate <= 0.0f) {
+                throw std::runtime_error("--stress-fire-rate must be positive");
+            }
+        } else if (arg == "--stress-bullet-speed") {
+            options.stress.bullet_speed = std::stof(std::string(value()));
+            if (options.stress.bullet_speed <= 0.0f) {
+                throw std::runtime_error("--stress-bullet-speed must be positive");
+            }
+        } else if (arg == "--population") {
+            options.population = std::stoul(std::string(value()));
+            if (options.population == 0 || options.population > 10'000'000) {
+                throw std::runtime_error("--population must be between 1 and 10000000 birds");
+            }
+        } else if (arg == "--seed") {
+            options.seed = std::stoull(std::string(value()));
+            seeded = true;
+        } else if (arg == "--autoplay") {
+            options.autoplay = value();
+        } else if (arg == "--sim-speed") {
+            const std::string_view speed = value();
+            options.sim_speed = speed == "max" ? 0.0f : std::stof(std::string(speed));
+            if (speed != "max" && options.sim_speed <= 0.0f) {
+                throw std::runtime_error("--sim-speed must be positive or max");
+            }
+        } else if (arg == "--record") {
+            options.record = value();
+        } else if (arg == "--keyframe-interval") {
+            options.keyframe_interval = static_cast<uint32_t>(std::stoul(std::string(value())));
+            if (options.keyframe_interval == 0) {
+                throw std::runtime_error("--keyframe-interval must be positive");
+            }
+        } else if (arg == "--replay") {
+            options.replay = value();
+        } else if (arg == "--hash-log") {
+            options.hash_log = value();
+        } else if (arg == "--max-ticks") {
+            options.max_ticks = std::stoull(std::string(value()));
+        } else if (arg == "--metrics-page") {
+            if (!core::metrics::PAGE_AVAILABLE) {
+                throw std::runtime_error("--metrics-page needs POSIX shared memory");
+            }
+            options.metrics_page = true;
+        } else if (arg == "--alloc-overlay") {
+            if (!core::alloc::TRACKING) {
+                std::cerr << "--alloc-overlay needs a build with RETRO_GAMES_TRACK_ALLOCATIONS=ON\n";
+            }
+            options.alloc_overlay = true;
+        } else {
+            throw std::runtime_error("Unknown option: " + std::string(arg));
+        }
+    }
+
+    // Frame-count and throughput runs need every frame rendered.
+    if (options.max_frames > 0 || options.uncapped) {
+        options.idle_throttle = false;
+    }
+
+    if (!seeded) {
+        std::random_device device;
+        options.seed = static_cast<uint64_t>(device()) << 32 | device();
+    }
+
+    // Scaled time has to be stepped in fixed ticks for the run to behave as it would live.
+    // So are recordings and hash logs, whose ticks are compared step for step.
+    if ((options.sim_speed != 1.0f || !options.record.empty() || !options.hash_log.empty()) && options.tick_rate <= 0.0f) {
+        options.tick_rate = DEFAULT_SIM_TICK_RATE;
+    }
+
+    return options;
+}
+
+int main(int argc, char *argv[]) {
+    core::alloc::hookSDL();
+
     try {
-        GameManager manager;
+        GameManager manager(parseLaunchOptions(argc, argv));
         manager.run();
         return 0;
     } catch (const std::exception &e) {
@@ -48,7 +48,7 @@ namespace menu {
         }
 
         void render(const core::Renderer &renderer) const {
-            core::Renderer::clear(0.05f, 0.05f, 0.1f);
+            renderer.clear(0.05f, 0.05f, 0.1f);
 
             renderer.drawTextCentered("RETRO GAMES COLLECTION",
                                       static_cast<float>(renderer.getWidth()) / 2.0f,
@@ -59,7 +59,7 @@ namespace menu {
             const float start_y = static_cast<float>(renderer.getHeight()) * 0.6f;
 
             for (size_t i = 0; i < items_.size(); ++i) {
-                constexpr float item_height = 60.0f;
+                constexpr float item_height = 50.0f;
                 const float y = start_y - static_cast<float>(i) * item_height;
 
                 if (i == selected_index_) {
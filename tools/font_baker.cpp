@@ -0,0 +1,182 @@
+// Build-time tool: rasterizes printable ASCII from a TrueType font at the given point
+// sizes into one 8-bit coverage atlas and writes it, with per-glyph metrics, as a
+// constexpr header for core::BakedFont.
+//
+// Usage: font_baker <font.ttf> <output.hpp> <size>...
+
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_ttf.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace {
+    constexpr int FIRST_GLYPH = 32;
+    constexpr int GLYPH_COUNT = 95;
+    constexpr int ATLAS_WIDTH = 1024;
+
+    struct Glyph {
+        int x{}, y{}, width{}, height{};
+        int offset_x{}, offset_y{};
+        int advance{};
+    };
+
+    struct Face {
+        int size{}, ascent{}, height{};
+        std::vector<Glyph> glyphs;
+    };
+
+    struct Atlas {
+        std::vector<unsigned char> pixels;
+        int height{0};
+        int pen_x{0}, pen_y{0}, row_height{0};
+
+        // Shelf packing: glyphs fill rows left to right, a new row opens when one is full.
+        void place(Glyph &glyph) {
+            if (pen_x + glyph.width > ATLAS_WIDTH) {
+                pen_x = 0;
+                pen_y += row_height + 1;
+                row_height = 0;
+            }
+            glyph.x = pen_x;
+            glyph.y = pen_y;
+            pen_x += glyph.width + 1;
+            row_height = std::max(row_height, glyph.height);
+
+            height = std::max(height, pen_y + glyph.height);
+            pixels.resize(static_cast<size_t>(ATLAS_WIDTH) * static_cast<size_t>(height), 0);
+        }
+    };
+
+    // Crops the glyph cell to its covered pixels and copies the coverage into the atlas.
+    bool bakeGlyph(TTF_Font *font, const Uint16 ch, Atlas &atlas, Glyph &glyph) {
+        int min_x = 0, max_x = 0, min_y = 0, max_y = 0;
+        if (TTF_GlyphMetrics(font, ch, &min_x, &max_x, &min_y, &max_y, &glyph.advance) != 0) return false;
+
+        SDL_Surface *rendered = TTF_RenderGlyph_Blended(font, ch, SDL_Color{255, 255, 255, 255});
+        if (!rendered) return ch == ' ';
+
+        SDL_Surface *rgba = SDL_ConvertSurfaceFormat(rendered, SDL_PIXELFORMAT_RGBA32, 0);
+        SDL_FreeSurface(rendered);
+        if (!rgba) return false;
+
+        const auto coverage = [&](const int x, const int y) {
+            return static_cast<const Uint8 *>(rgba->pixels)[y * rgba->pitch + x * 4 + 3];
+        };
+
+        int left = rgba->w, right = -1, top = rgba->h, bottom = -1;
+        for (int y = 0; y < rgba->h; ++y) {
+            for (int x = 0; x < rgba->w; ++x) {
+                if (coverage(x, y) == 0) continue;
+                left = std::min(left, x);
+                right = std::max(right, x);
+                top = std::min(top, y);
+                bottom = std::max(bottom, y);
+            }
+        }
+
+        if (right >= left) {
+            // SDL_ttf shifts glyphs that extend left of the pen so the cell starts at min_x.
+            glyph.offset_x = left + std::min(0, min_x);
+            glyph.offset_y = top;
+            glyph.width = right - left + 1;
+            glyph.height = bottom - top + 1;
+            atlas.place(glyph);
+
+            for (int y = 0; y < glyph.height; ++y) {
+                for (int x = 0; x < glyph.width; ++x) {
+                    atlas.pixels[static_cast<size_t>(glyph.y + y) * ATLAS_WIDTH + static_cast<size_t>(glyph.x + x)] =
+                            coverage(left + x, top + y);
+                }
+            }
+        }
+
+        SDL_FreeSurface(rgba);
+        return true;
+    }
+
+    void writeHeader(std::ofstream &out, const Atlas &atlas, const std::vector<Face> &faces) {
+        out << "// Generated by tools/font_baker.cpp. Do not edit.\n"
+                "#pragma once\n"
+                "#include <array>\n"
+                "#include <cstdint>\n\n"
+                "namespace core::baked_font {\n"
+                "    struct Glyph {\n"
+                "        uint16_t x, y, width, height;\n"
+                "        int16_t offset_x, offset_y, advance;\n"
+                "    };\n\n"
+                "    inline constexpr int FIRST_GLYPH = " << FIRST_GLYPH << ";\n"
+                "    inline constexpr int GLYPH_COUNT = " << GLYPH_COUNT << ";\n\n"
+                "    struct Face {\n"
+                "        int size, ascent, height;\n"
+                "        std::array<Glyph, GLYPH_COUNT> glyphs;\n"
+                "    };\n\n"
+                "    inline constexpr int ATLAS_WIDTH = " << ATLAS_WIDTH << ";\n"
+                "    inline constexpr int ATLAS_HEIGHT = " << atlas.height << ";\n\n"
+                "    inline constexpr uint8_t ATLAS[] = {";
+
+        for (size_t i = 0; i < atlas.pixels.size(); ++i) {
+            out << (i % 32 == 0 ? "\n        " : "") << static_cast<int>(atlas.pixels[i]) << ',';
+        }
+        out << "\n    };\n\n"
+                "    inline constexpr std::array<Face, " << faces.size() << "> FACES{{\n";
+
+        for (const Face &face: faces) {
+            out << "        {" << face.size << ", " << face.ascent << ", " << face.height << ", {{\n";
+            for (const Glyph &g: face.glyphs) {
+                out << "            {" << g.x << ", " << g.y << ", " << g.width << ", " << g.height << ", "
+                        << g.offset_x << ", " << g.offset_y << ", " << g.advance << "},\n";
+            }
+            out << "        }}},\n";
+        }
+        out << "    }};\n}\n";
+    }
+}
+
+int main(int argc, char *argv[]) {
+    if (argc < 4) {
+        std::fprintf(stderr, "Usage: %s <font.ttf> <output.hpp> <size>...\n", argv[0]);
+        return 1;
+    }
+
+    if (TTF_Init() != 0) {
+        std::fprintf(stderr, "TTF_Init failed: %s\n", TTF_GetError());
+        return 1;
+    }
+
+    Atlas atlas;
+    std::vector<Face> faces;
+
+    for (int arg = 3; arg < argc; ++arg) {
+        const int size = std::atoi(argv[arg]);
+        TTF_Font *font = TTF_OpenFont(argv[1], size);
+        if (!font) {
+            std::fprintf(stderr, "Cannot open %s at size %d: %s\n", argv[1], size, TTF_GetError());
+            return 1;
+        }
+        TTF_SetFontHinting(font, TTF_HINTING_NORMAL);
+
+        Face face{size, TTF_FontAscent(font), TTF_FontHeight(font), std::vector<Glyph>(GLYPH_COUNT)};
+        for (int i = 0; i < GLYPH_COUNT; ++i) {
+            if (!bakeGlyph(font, static_cast<Uint16>(FIRST_GLYPH + i), atlas, face.glyphs[static_cast<size_t>(i)])) {
+                std::fprintf(stderr, "Cannot rasterize glyph %d at size %d\n", FIRST_GLYPH + i, size);
+                return 1;
+            }
+        }
+        faces.push_back(std::move(face));
+        TTF_CloseFont(font);
+    }
+
+    std::ofstream out(argv[2]);
+    if (!out) {
+        std::fprintf(stderr, "Cannot write %s\n", argv[2]);
+        return 1;
+    }
+    writeHeader(out, atlas, faces);
+
+    TTF_Quit();
+    return 0;
+}
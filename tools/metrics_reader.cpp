@@ -0,0 +1,119 @@
+// Samples the live metrics page a running game publishes with --metrics-page and prints
+// one line per interval: frame rate, frame-time percentiles, ticks, draw calls and
+// allocations over that interval, plus audio underruns in the interval and the worst
+// sound command latency so far. Reading never blocks the game.
+//
+// Usage: metrics_reader <pid | /name> [interval-ms] [samples]
+
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+
+#include "core/metrics_page.hpp"
+
+namespace {
+    const char *stateName(const uint32_t state) {
+        switch (state) {
+            case 0: return "menu";
+            case 1: return "in-game";
+            case 2: return "quitting";
+            default: return "?";
+        }
+    }
+
+    // Upper bound, in milliseconds, of the bucket holding the given fraction of frames.
+    double percentileMs(const core::metrics::Snapshot &now, const core::metrics::Snapshot &then, const double fraction) {
+        uint64_t total = 0;
+        for (size_t i = 0; i < core::metrics::HISTOGRAM_BUCKETS; ++i) {
+            total += now.frame_time_histogram[i] - then.frame_time_histogram[i];
+        }
+        if (total == 0) return 0.0;
+
+        uint64_t seen = 0;
+        for (size_t i = 0; i < core::metrics::HISTOGRAM_BUCKETS; ++i) {
+            seen += now.frame_time_histogram[i] - then.frame_time_histogram[i];
+            if (static_cast<double>(seen) >= fraction * static_cast<double>(total)) {
+                return static_cast<double>(core::metrics::BUCKET_BASE_US << i) / 1000.0;
+            }
+        }
+        return static_cast<double>(core::metrics::BUCKET_BASE_US << (core::metrics::HISTOGRAM_BUCKETS - 1)) / 1000.0;
+    }
+}
+
+int main(int argc, char *argv[]) {
+    if (argc < 2) {
+        std::fprintf(stderr, "Usage: %s <pid | /name> [interval-ms] [samples]\n", argv[0]);
+        return 1;
+    }
+
+    const std::string name = argv[1][0] == '/' ? argv[1] : "/retro_games." + std::string(argv[1]);
+    const int interval_ms = argc > 2 ? std::atoi(argv[2]) : 1000;
+    const long samples = argc > 3 ? std::atol(argv[3]) : -1;
+
+    const int fd = shm_open(name.c_str(), O_RDONLY, 0);
+    if (fd < 0) {
+        std::perror(("Cannot open metrics page " + name).c_str());
+        return 1;
+    }
+    void *memory = mmap(nullptr, sizeof(core::metrics::Page), PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (memory == MAP_FAILED) {
+        std::perror("mmap");
+        return 1;
+    }
+
+    const auto &page = *static_cast<const core::metrics::Page *>(memory);
+    if (page.magic.load(std::memory_order_acquire) != core::metrics::MAGIC || page.version != core::metrics::VERSION) {
+        std::fprintf(stderr, "%s is not a version %u metrics page\n", name.c_str(), core::metrics::VERSION);
+        return 1;
+    }
+
+    core::metrics::Snapshot then;
+    if (!core::metrics::read(page, then)) {
+        std::fprintf(stderr, "Metrics page stayed busy\n");
+        return 1;
+    }
+    auto then_time = std::chrono::steady_clock::now();
+
+    std::printf("%-9s %-16s %8s %8s %8s %8s %10s %10s %9s %9s\n",
+                "state", "game", "fps", "p50 ms", "p99 ms", "ticks/s", "draws/f", "allocs/f", "underrun", "audio ms");
+    for (long sample = 0; samples < 0 || sample < samples; ++sample) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(interval_ms));
+        if (kill(static_cast<pid_t>(page.pid), 0) != 0) {
+            std::printf("process %lld exited\n", static_cast<long long>(page.pid));
+            break;
+        }
+
+        core::metrics::Snapshot now;
+        if (!core::metrics::read(page, now)) continue;
+
+        const auto now_time = std::chrono::steady_clock::now();
+        const double seconds = std::chrono::duration<double>(now_time - then_time).count();
+        const uint64_t frames = now.frames - then.frames;
+        const double per_frame = frames > 0 ? 1.0 / static_cast<double>(frames) : 0.0;
+
+        std::printf("%-9s %-16.*s %8.1f %8.1f %8.1f %8.0f %10.1f %10.1f %9llu %9.2f\n",
+                    stateName(now.app_state),
+                    static_cast<int>(now.gameName().size()), now.gameName().data(),
+                    static_cast<double>(frames) / seconds,
+                    percentileMs(now, then, 0.5), percentileMs(now, then, 0.99),
+                    static_cast<double>(now.ticks - then.ticks) / seconds,
+                    static_cast<double>(now.draw_calls - then.draw_calls) * per_frame,
+                    static_cast<double>(now.allocations - then.allocations) * per_frame,
+                    static_cast<unsigned long long>(now.audio_underruns - then.audio_underruns),
+                    static_cast<double>(now.audio_latency_us) / 1000.0);
+        std::fflush(stdout);
+
+        then = now;
+        then_time = now_time;
+    }
+
+    munmap(memory, sizeof(core::metrics::Page));
+    return 0;
+}